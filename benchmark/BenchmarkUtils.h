@@ -0,0 +1,86 @@
+#pragma once
+#include "Table.h"
+#include <algorithm>
+#include <chrono>
+#include <random>
+#include <string>
+#include <vector>
+
+// measures time from construction or from the last reset
+class Timer {
+
+public:
+
+    Timer() : start(std::chrono::steady_clock::now()) {}
+
+    void reset() {
+        start = std::chrono::steady_clock::now();
+    }
+
+    double getSeconds() const {
+        return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    }
+
+private:
+
+    std::chrono::steady_clock::time_point start;
+
+};
+
+// reads the first argument of command line as size or returns default size
+inline size_t getSizeFromArgs(int argc, char** argv, size_t defaultSize) {
+    return argc > 1 ? std::stoull(argv[1]) : defaultSize;
+}
+
+// generators of sets of n unique keys
+// keys are sorted, so they can be inserted to any table quickly
+
+inline std::vector<KeyType> makeUniqueSorted(std::vector<KeyType> keys) {
+    std::sort(keys.begin(), keys.end());
+    keys.erase(std::unique(keys.begin(), keys.end()), keys.end());
+    return keys;
+}
+
+// keys are uniformly distributed over all range of KeyType
+inline std::vector<KeyType> generateUniformKeys(size_t n, unsigned seed = 1) {
+    std::default_random_engine randGen(seed);
+    std::uniform_int_distribution<KeyType> dist;
+    std::vector<KeyType> keys(n);
+    for (auto& key : keys)
+        key = dist(randGen);
+    return makeUniqueSorted(keys);
+}
+
+// keys are dense ranges placed at random points
+inline std::vector<KeyType> generateClusteredKeys(size_t n, size_t clustersCount = 64, unsigned seed = 1) {
+    std::default_random_engine randGen(seed);
+    std::uniform_int_distribution<KeyType> dist;
+    std::vector<KeyType> keys(n);
+    size_t clusterSize = (n + clustersCount - 1) / clustersCount;
+    for (size_t i = 0; i < n; i += clusterSize) {
+        KeyType first = dist(randGen) / 2;
+        for (size_t j = i; j < std::min(n, i + clusterSize); j++)
+            keys[j] = first + KeyType(j - i) * 3;
+    }
+    return makeUniqueSorted(keys);
+}
+
+// density of keys decreases exponentially
+inline std::vector<KeyType> generateSkewedKeys(size_t n, unsigned seed = 1) {
+    std::default_random_engine randGen(seed);
+    std::exponential_distribution<double> dist(12.0);
+    std::vector<KeyType> keys(n);
+    for (auto& key : keys)
+        key = KeyType(std::min(dist(randGen), 1.0) * UINT32_MAX);
+    return makeUniqueSorted(keys);
+}
+
+// queries are chosen randomly among keys, a half of them are missing in table
+inline std::vector<KeyType> generateQueries(const std::vector<KeyType>& keys, size_t n, unsigned seed = 2) {
+    std::default_random_engine randGen(seed);
+    std::uniform_int_distribution<size_t> dist(0, keys.size() - 1);
+    std::vector<KeyType> queries(n);
+    for (size_t i = 0; i < n; i++)
+        queries[i] = keys[dist(randGen)] + KeyType(i % 2);
+    return queries;
+}
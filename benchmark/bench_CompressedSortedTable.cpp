@@ -0,0 +1,45 @@
+#include "CompressedSortedTable.h"
+#include "SortedTable.h"
+#include "BenchmarkUtils.h"
+#include <cstdio>
+
+// compares searches in CompressedSortedTable and SortedTable and memory used for keys
+// usage: bench_CompressedSortedTable [number of keys]
+
+void runBenchmark(const char* distributionName, const std::vector<KeyType>& keys) {
+    std::vector<std::pair<KeyType, KeyType>> elems;
+    for (KeyType key : keys)
+        elems.push_back(std::make_pair(key, key));
+    CompressedSortedTable<KeyType> compressedTable(elems.begin(), elems.end());
+    SortedTable<KeyType> sortedTable;
+    for (KeyType key : keys)
+        sortedTable.insertWithoutSearch(key, KeyType(key));
+    std::vector<KeyType> queries = generateQueries(keys, size_t(1) << 22);
+
+    std::printf("%s keys (%zu):\n", distributionName, keys.size());
+
+    size_t found = 0;
+    Timer timer;
+    for (KeyType query : queries)
+        found += sortedTable.find(query) != sortedTable.end();
+    double seconds = timer.getSeconds();
+    // keys are stored in pairs with values, so padding of pairs is counted too
+    size_t keysMemory = keys.size() * (sizeof(std::pair<KeyType, KeyType>) - sizeof(KeyType));
+    std::printf("    %-24s %8.1f ns/find  keys %8zu KB  (found %zu)\n", "SortedTable",
+        seconds * 1e9 / queries.size(), keysMemory >> 10, found);
+
+    found = 0;
+    timer.reset();
+    for (KeyType query : queries)
+        found += compressedTable.find(query) != compressedTable.end();
+    seconds = timer.getSeconds();
+    std::printf("    %-24s %8.1f ns/find  keys %8zu KB  (found %zu)\n", "CompressedSortedTable",
+        seconds * 1e9 / queries.size(), compressedTable.getKeysMemorySize() >> 10, found);
+}
+
+int main(int argc, char** argv) {
+    size_t n = getSizeFromArgs(argc, argv, size_t(1) << 24);
+    runBenchmark("uniform", generateUniformKeys(n));
+    runBenchmark("clustered", generateClusteredKeys(n));
+    return 0;
+}
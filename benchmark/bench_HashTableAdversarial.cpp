@@ -0,0 +1,69 @@
+#include "HashTable.h"
+#include "BenchmarkUtils.h"
+#include <cstdio>
+
+// compares hash tables on structured keys which are bad for weak hash functions
+// "weak seed" tables start with parameter of hash function which puts keys to few cells,
+// so they are slow until they are reseeded
+// usage: bench_HashTableAdversarial [number of keys]
+
+// hash(key) = key >> (W - M), it is the same as the old hash with a = 1
+template <class TableType>
+class WeakSeedTable : public TableType {
+
+public:
+
+    WeakSeedTable() {
+        this->a = uint64_t(1) << 32;
+    }
+
+};
+
+template <class TableType>
+void runBenchmark(const char* tableName, const std::vector<KeyType>& keys, bool isAutoReseeding) {
+    TableType table;
+    table.setAutoReseeding(isAutoReseeding);
+    Timer timer;
+    for (KeyType key : keys)
+        table.insert(key, key);
+    double insertSeconds = timer.getSeconds();
+
+    size_t found = 0;
+    timer.reset();
+    for (KeyType key : keys)
+        found += table.find(key) != table.end();
+    double findSeconds = timer.getSeconds();
+
+    std::printf("    %-40s %8.1f ns/insert %8.1f ns/find   probe length avg %5.2f max %4u   reseeds %u%s\n",
+        tableName, insertSeconds * 1e9 / keys.size(), findSeconds * 1e9 / keys.size(),
+        table.getAverageProbeLength(), table.getMaxProbeLength(), table.getReseedsCount(),
+        found == keys.size() ? "" : "  (ERROR: not all keys are found)");
+}
+
+void runBenchmarks(const char* keysName, const std::vector<KeyType>& keys) {
+    std::printf("%s (%zu):\n", keysName, keys.size());
+    runBenchmark<HashTableOpenAddressing<KeyType>>("open addressing", keys, false);
+    runBenchmark<HashTableOpenAddressing<KeyType>>("open addressing, reseeding", keys, true);
+    runBenchmark<WeakSeedTable<HashTableOpenAddressing<KeyType>>>("open addressing, weak seed, reseeding",
+        keys, true);
+    runBenchmark<HashTableSeparateChaining<KeyType>>("separate chaining", keys, false);
+    runBenchmark<HashTableSeparateChaining<KeyType>>("separate chaining, reseeding", keys, true);
+    runBenchmark<WeakSeedTable<HashTableSeparateChaining<KeyType>>>("separate chaining, weak seed, reseeding",
+        keys, true);
+}
+
+int main(int argc, char** argv) {
+    size_t n = getSizeFromArgs(argc, argv, size_t(1) << 18);
+    std::vector<KeyType> sequential(n), multiples(n), highBytes(n), grid(n);
+    for (size_t i = 0; i < n; i++) {
+        sequential[i] = KeyType(i);
+        multiples[i] = KeyType(i << 12);                            // multiples of large power of two
+        highBytes[i] = KeyType(((i & 0xFF) << 24) | (i >> 8));      // the highest byte changes the most often
+        grid[i] = KeyType(((i >> 4) << 16) | (i & 0xF));            // a few keys near multiples of 2^16
+    }
+    runBenchmarks("sequential keys", sequential);
+    runBenchmarks("multiples of 2^12", makeUniqueSorted(multiples));
+    runBenchmarks("keys with changing highest byte", highBytes);
+    runBenchmarks("keys near multiples of 2^16", makeUniqueSorted(grid));
+    return 0;
+}
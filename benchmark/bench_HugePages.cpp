@@ -0,0 +1,114 @@
+#include "SortedTable.h"
+#include "HashTable.h"
+#include "HugePageAllocator.h"
+#include "BenchmarkUtils.h"
+#include <cstdio>
+#include <cstring>
+
+#ifdef __linux__
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+// compares lookups in large tables allocated by std::allocator and HugePageAllocator
+// on Linux data TLB misses are counted by perf_event_open (if it is permitted)
+// usage: bench_HugePages [number of keys]
+
+// counter of data TLB load misses of this thread
+class TlbMissCounter {
+
+public:
+
+    TlbMissCounter() {
+#ifdef __linux__
+        perf_event_attr attr;
+        std::memset(&attr, 0, sizeof(attr));
+        attr.size = sizeof(attr);
+        attr.type = PERF_TYPE_HW_CACHE;
+        attr.config = PERF_COUNT_HW_CACHE_DTLB | (PERF_COUNT_HW_CACHE_OP_READ << 8) |
+            (PERF_COUNT_HW_CACHE_RESULT_MISS << 16);
+        attr.disabled = 1;
+        attr.exclude_kernel = 1;
+        fd = int(syscall(__NR_perf_event_open, &attr, 0, -1, -1, 0));
+#endif
+    }
+
+    ~TlbMissCounter() {
+#ifdef __linux__
+        if (fd >= 0)
+            close(fd);
+#endif
+    }
+
+    bool isAvailable() const {
+        return fd >= 0;
+    }
+
+    void start() {
+#ifdef __linux__
+        if (fd >= 0) {
+            ioctl(fd, PERF_EVENT_IOC_RESET, 0);
+            ioctl(fd, PERF_EVENT_IOC_ENABLE, 0);
+        }
+#endif
+    }
+
+    long long stop() {
+        long long count = -1;
+#ifdef __linux__
+        if (fd >= 0) {
+            ioctl(fd, PERF_EVENT_IOC_DISABLE, 0);
+            if (read(fd, &count, sizeof(count)) != sizeof(count))
+                count = -1;
+        }
+#endif
+        return count;
+    }
+
+private:
+
+    int fd = -1;
+
+};
+
+template <class TableType>
+void runBenchmark(const char* name, const std::vector<KeyType>& keys, const std::vector<KeyType>& queries) {
+    TableType table;
+    for (KeyType key : keys)
+        table.insertWithoutSearch(key, KeyType(key));
+
+    TlbMissCounter counter;
+    size_t found = 0;
+    counter.start();
+    Timer timer;
+    for (KeyType query : queries)
+        found += table.find(query) != table.end();
+    double seconds = timer.getSeconds();
+    long long misses = counter.stop();
+
+    std::printf("    %-52s %8.1f ns/find", name, seconds * 1e9 / queries.size());
+    if (misses >= 0)
+        std::printf("  %6.3f dTLB misses/find", double(misses) / queries.size());
+    std::printf("  (found %zu)\n", found);
+}
+
+int main(int argc, char** argv) {
+    size_t n = getSizeFromArgs(argc, argv, size_t(1) << 24);
+    std::vector<KeyType> keys = generateUniformKeys(n);
+    std::vector<KeyType> queries = generateQueries(keys, size_t(1) << 22);
+    if (!TlbMissCounter().isAvailable())
+        std::printf("dTLB misses are not counted: perf events are not available\n");
+
+    std::printf("%zu keys:\n", keys.size());
+    runBenchmark<SortedTable<KeyType>>("SortedTable", keys, queries);
+    runBenchmark<SortedTable<KeyType, HugePageAllocator<KeyType>>>(
+        "SortedTable + HugePageAllocator", keys, queries);
+    runBenchmark<HashTableOpenAddressing<KeyType>>("HashTableOpenAddressing", keys, queries);
+    runBenchmark<HashTableOpenAddressing<KeyType, HugePageAllocator<KeyType>>>(
+        "HashTableOpenAddressing + HugePageAllocator", keys, queries);
+    runBenchmark<HashTableOpenAddressing<KeyType, HugePageAllocator<KeyType, true>>>(
+        "HashTableOpenAddressing + HugePageAllocator(HUGETLB)", keys, queries);
+    return 0;
+}
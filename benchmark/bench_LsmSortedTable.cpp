@@ -0,0 +1,44 @@
+#include "SortedTable.h"
+#include "LsmSortedTable.h"
+#include "BenchmarkUtils.h"
+#include <cstdio>
+
+// compares LsmSortedTable with SortedTable on random insertions, erasures and searches
+// usage: bench_LsmSortedTable [number of keys]
+
+template <class TableType>
+void runBenchmark(const char* tableName, const std::vector<KeyType>& keys,
+    const std::vector<KeyType>& queries) {
+    TableType table;
+    Timer timer;
+    for (KeyType key : keys)
+        table.insert(key, KeyType(key));
+    double insertSeconds = timer.getSeconds();
+
+    size_t found = 0;
+    timer.reset();
+    for (KeyType query : queries)
+        found += table.find(query) != table.end();
+    double findSeconds = timer.getSeconds();
+
+    timer.reset();
+    for (size_t i = 0; i < keys.size(); i += 2)
+        table.erase(keys[i]);
+    double eraseSeconds = timer.getSeconds();
+
+    std::printf("    %-16s %8.1f ns/insert %8.1f ns/find %8.1f ns/erase  (found %zu)\n", tableName,
+        insertSeconds * 1e9 / keys.size(), findSeconds * 1e9 / queries.size(),
+        eraseSeconds * 2e9 / keys.size(), found);
+}
+
+int main(int argc, char** argv) {
+    size_t n = getSizeFromArgs(argc, argv, size_t(1) << 17);
+    std::vector<KeyType> keys = generateUniformKeys(n);
+    std::vector<KeyType> queries = generateQueries(keys, 4 * keys.size());
+    std::shuffle(keys.begin(), keys.end(), std::default_random_engine(3));
+
+    std::printf("random keys (%zu):\n", keys.size());
+    runBenchmark<SortedTable<KeyType>>("SortedTable", keys, queries);
+    runBenchmark<LsmSortedTable<KeyType>>("LsmSortedTable", keys, queries);
+    return 0;
+}
@@ -0,0 +1,79 @@
+#include "HashTable.h"
+#include "MultiTable.h"
+#include "BenchmarkUtils.h"
+#include <cstdio>
+
+// compares multimap tables with HashTableOpenAddressing of vectors
+// values of keys are inserted in random order, then all values of random keys are scanned
+// usage: bench_MultiTable [number of values]
+
+const size_t VALUES_PER_KEY = 8;
+
+// inserts values one by one in random order, so values of a key are not inserted together
+template <class TableType>
+void insertValues(TableType& table, const std::vector<KeyType>& order) {
+    for (KeyType key : order)
+        table.insert(key, key);
+}
+
+void insertValues(HashTableOpenAddressing<std::vector<KeyType>>& table, const std::vector<KeyType>& order) {
+    for (KeyType key : order) {
+        auto it = table.find(key);
+        if (it == table.end())
+            it = table.insertWithoutSearch(key, std::vector<KeyType>());
+        it->second.push_back(key);
+    }
+}
+
+template <class TableType>
+size_t scanValues(TableType& table, KeyType key) {
+    size_t sum = 0;
+    auto range = table.equalRange(key);
+    for (; range.first != range.second; ++range.first)
+        sum += range.first->second;
+    return sum;
+}
+
+size_t scanValues(HashTableOpenAddressing<std::vector<KeyType>>& table, KeyType key) {
+    size_t sum = 0;
+    auto it = table.find(key);
+    if (it != table.end())
+        for (KeyType value : it->second)
+            sum += value;
+    return sum;
+}
+
+template <class TableType>
+void runBenchmark(const char* tableName, const std::vector<KeyType>& order, const std::vector<KeyType>& queries) {
+    TableType table;
+    Timer timer;
+    insertValues(table, order);
+    double insertSeconds = timer.getSeconds();
+
+    size_t sum = 0;
+    timer.reset();
+    for (KeyType query : queries)
+        sum += scanValues(table, query);
+    double scanSeconds = timer.getSeconds();
+
+    std::printf("    %-44s %8.1f ns/insert %8.1f ns/scan of key  (sum %zu)\n", tableName,
+        insertSeconds * 1e9 / order.size(), scanSeconds * 1e9 / queries.size(), sum);
+}
+
+int main(int argc, char** argv) {
+    size_t n = getSizeFromArgs(argc, argv, size_t(1) << 22);
+    std::vector<KeyType> keys = generateUniformKeys(n / VALUES_PER_KEY);
+    std::vector<KeyType> order;
+    for (KeyType key : keys)
+        order.insert(order.end(), VALUES_PER_KEY, key);
+    std::shuffle(order.begin(), order.end(), std::default_random_engine(3));
+    std::vector<KeyType> queries = generateQueries(keys, n);
+
+    std::printf("%zu keys, %zu values per key, %zu scans:\n", keys.size(), VALUES_PER_KEY, queries.size());
+    runBenchmark<HashTableOpenAddressing<std::vector<KeyType>>>("HashTableOpenAddressing<std::vector>",
+        order, queries);
+    runBenchmark<HashMultiTable<KeyType>>("HashMultiTable", order, queries);
+    if (n <= (size_t(1) << 20))  // insertion to SortedMultiTable is O(n)
+        runBenchmark<SortedMultiTable<KeyType>>("SortedMultiTable", order, queries);
+    return 0;
+}
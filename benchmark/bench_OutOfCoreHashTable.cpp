@@ -0,0 +1,69 @@
+#include "HashTable.h"
+#include "OutOfCoreHashTable.h"
+#include "BenchmarkUtils.h"
+#include <cstdio>
+
+// compares OutOfCoreHashTable under different memory budgets with HashTableOpenAddressing
+// keys are scattered over all partitions by hash, so a successful search in a spilled partition
+// reads the whole partition, and misses are mostly rejected by bloom filters
+// usage: bench_OutOfCoreHashTable [number of keys]
+
+template <class TableType>
+void runQueries(TableType& table, const std::vector<KeyType>& hits, const std::vector<KeyType>& misses) {
+    size_t found = 0;
+    Timer timer;
+    for (KeyType query : hits)
+        found += table.find(query) != table.end();
+    double hitSeconds = timer.getSeconds();
+
+    timer.reset();
+    for (KeyType query : misses)
+        found += table.find(query) != table.end();
+    double missSeconds = timer.getSeconds();
+
+    std::printf("%10.1f ns/hit %8.1f ns/miss  (found %zu)", hitSeconds * 1e9 / hits.size(),
+        missSeconds * 1e9 / misses.size(), found);
+}
+
+void runHashTable(const std::vector<KeyType>& keys, const std::vector<KeyType>& hits,
+    const std::vector<KeyType>& misses) {
+    HashTableOpenAddressing<KeyType> table;
+    Timer timer;
+    for (KeyType key : keys)
+        table.insert(key, KeyType(key));
+    std::printf("    %-24s %8.1f ns/insert", "HashTableOpenAddressing", timer.getSeconds() * 1e9 / keys.size());
+
+    runQueries(table, hits, misses);
+    std::printf("\n");
+}
+
+void runOutOfCoreTable(const std::vector<KeyType>& keys, const std::vector<KeyType>& hits,
+    const std::vector<KeyType>& misses, size_t budget) {
+    OutOfCoreHashTable<KeyType> table(budget);
+    Timer timer;
+    for (KeyType key : keys)
+        table.insert(key, KeyType(key));
+    std::printf("    budget %10zu KB      %8.1f ns/insert", budget >> 10, timer.getSeconds() * 1e9 / keys.size());
+
+    size_t loadsCount = table.getLoadsCount(), skipsCount = table.getFilterSkipsCount();
+    runQueries(table, hits, misses);
+    std::printf("  partitions %zu, spilled %zu, loads %zu, filter skips %zu\n", table.getPartitionsCount(),
+        table.getSpilledPartitionsCount(), table.getLoadsCount() - loadsCount,
+        table.getFilterSkipsCount() - skipsCount);
+}
+
+int main(int argc, char** argv) {
+    size_t n = getSizeFromArgs(argc, argv, size_t(1) << 20);
+    std::vector<KeyType> keys = generateUniformKeys(n);
+    std::shuffle(keys.begin(), keys.end(), std::default_random_engine(3));
+    std::vector<KeyType> hits(keys.begin(), keys.begin() + keys.size() / 64);
+    std::vector<KeyType> misses = generateUniformKeys(keys.size(), 4);
+    // a cell of HashTableOpenAddressing<KeyType> takes 12 bytes, there are about 2 cells per key
+    size_t dataSize = keys.size() * 24;
+
+    std::printf("random keys (%zu), %zu hits, %zu misses:\n", keys.size(), hits.size(), misses.size());
+    runHashTable(keys, hits, misses);
+    for (size_t divisor : { 1, 4, 16 })
+        runOutOfCoreTable(keys, hits, misses, 2 * dataSize / divisor);
+    return 0;
+}
@@ -0,0 +1,40 @@
+#include "SortedTable.h"
+#include "BenchmarkUtils.h"
+#include <cstdio>
+
+// compares SortedTable::findBatch (interleaved binary searches with prefetch) with a loop of find calls
+// the table is much larger than cache, so every step of binary search is a cache miss
+// usage: bench_SortedTableBatch [number of keys]
+
+int main(int argc, char** argv) {
+    size_t n = getSizeFromArgs(argc, argv, size_t(1) << 24);
+    std::vector<KeyType> keys = generateUniformKeys(n);
+    std::vector<KeyType> queries = generateQueries(keys, size_t(1) << 22);
+    SortedTable<KeyType> table;
+    for (KeyType key : keys)
+        table.insertWithoutSearch(key, KeyType(key));
+
+    std::printf("random keys (%zu), %zu searches:\n", keys.size(), queries.size());
+    for (auto strategy : { SortedTableSearchStrategy::BINARY, SortedTableSearchStrategy::BRANCHLESS_BINARY }) {
+        table.setSearchStrategy(strategy);
+        size_t found = 0;
+        Timer timer;
+        for (KeyType query : queries)
+            found += table.find(query) != table.end();
+        double seconds = timer.getSeconds();
+        std::printf("    find, %-24s %8.1f ns/find  (found %zu)\n",
+            strategy == SortedTableSearchStrategy::BINARY ? "binary" : "branchless binary",
+            seconds * 1e9 / queries.size(), found);
+    }
+
+    std::vector<SortedTable<KeyType>::iterator> results;
+    results.reserve(queries.size());
+    Timer timer;
+    table.findBatch(queries.begin(), queries.end(), std::back_inserter(results));
+    double seconds = timer.getSeconds();
+    size_t found = 0;
+    for (const auto& it : results)
+        found += it != table.end();
+    std::printf("    %-30s %8.1f ns/find  (found %zu)\n", "findBatch", seconds * 1e9 / queries.size(), found);
+    return 0;
+}
@@ -0,0 +1,48 @@
+#include "SortedTable.h"
+#include "BenchmarkUtils.h"
+#include <cstdio>
+
+// compares search strategies of SortedTable for different distributions of keys
+// usage: bench_SortedTableSearch [number of keys]
+
+const char* getStrategyName(SortedTableSearchStrategy strategy) {
+    switch (strategy) {
+    case SortedTableSearchStrategy::BINARY: return "binary";
+    case SortedTableSearchStrategy::BRANCHLESS_BINARY: return "branchless binary";
+    case SortedTableSearchStrategy::INTERPOLATION: return "interpolation";
+    case SortedTableSearchStrategy::INTERPOLATION_SEQUENTIAL: return "interpolation-sequential";
+    default: return "auto";
+    }
+}
+
+void runBenchmark(const char* distributionName, const std::vector<KeyType>& keys) {
+    SortedTable<KeyType> table;
+    for (KeyType key : keys)
+        table.insertWithoutSearch(key, KeyType(key));
+    std::vector<KeyType> queries = generateQueries(keys, 4 * keys.size());
+
+    std::printf("%s keys (%zu):\n", distributionName, keys.size());
+    for (auto strategy : { SortedTableSearchStrategy::BINARY, SortedTableSearchStrategy::BRANCHLESS_BINARY,
+        SortedTableSearchStrategy::INTERPOLATION, SortedTableSearchStrategy::INTERPOLATION_SEQUENTIAL,
+        SortedTableSearchStrategy::AUTO }) {
+        table.setSearchStrategy(strategy);
+        size_t found = 0;
+        Timer timer;
+        for (KeyType query : queries)
+            found += table.find(query) != table.end();
+        double seconds = timer.getSeconds();
+        std::printf("    %-26s %8.1f ns/find  (found %zu", getStrategyName(strategy),
+            seconds * 1e9 / queries.size(), found);
+        if (strategy == SortedTableSearchStrategy::AUTO)
+            std::printf(", chosen %s", getStrategyName(table.getCurrentSearchStrategy()));
+        std::printf(")\n");
+    }
+}
+
+int main(int argc, char** argv) {
+    size_t n = getSizeFromArgs(argc, argv, size_t(1) << 20);
+    runBenchmark("uniform", generateUniformKeys(n));
+    runBenchmark("clustered", generateClusteredKeys(n));
+    runBenchmark("skewed", generateSkewedKeys(n));
+    return 0;
+}
@@ -0,0 +1,37 @@
+#include "HashTable.h"
+#include "StaticHashTable.h"
+#include "BenchmarkUtils.h"
+#include <cstdio>
+
+// compares StaticHashTable with HashTableOpenAddressing on searches in small tables
+// usage: bench_StaticHashTable [number of searches]
+
+const size_t CAPACITY = 1000;
+
+template <class TableType>
+void runBenchmark(const char* tableName, TableType& table, const std::vector<KeyType>& keys,
+    const std::vector<KeyType>& queries) {
+    for (KeyType key : keys)
+        table.insert(key, KeyType(key));
+
+    size_t found = 0;
+    Timer timer;
+    for (KeyType query : queries)
+        found += table.find(query) != table.end();
+    double findSeconds = timer.getSeconds();
+
+    std::printf("    %-24s %8.2f ns/find  (found %zu)\n", tableName, findSeconds * 1e9 / queries.size(), found);
+}
+
+int main(int argc, char** argv) {
+    size_t n = getSizeFromArgs(argc, argv, size_t(1) << 24);
+    std::vector<KeyType> keys = generateUniformKeys(CAPACITY);
+    std::vector<KeyType> queries = generateQueries(keys, n);
+
+    std::printf("table of %zu random keys, %zu searches:\n", keys.size(), queries.size());
+    HashTableOpenAddressing<KeyType> hashTable;
+    runBenchmark("HashTableOpenAddressing", hashTable, keys, queries);
+    StaticHashTable<KeyType, CAPACITY> staticTable;
+    runBenchmark("StaticHashTable", staticTable, keys, queries);
+    return 0;
+}
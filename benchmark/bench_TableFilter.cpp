@@ -0,0 +1,47 @@
+#include "SortedTable.h"
+#include "HashTable.h"
+#include "BenchmarkUtils.h"
+#include <cstdio>
+
+// compares searches with and without bloom filter in front of SortedTable and HashTableSeparateChaining
+// 9 of 10 searched keys are missing in table
+// usage: bench_TableFilter [number of keys]
+
+template <class TableType>
+void runBenchmark(const char* tableName, const std::vector<KeyType>& keys, const std::vector<KeyType>& queries) {
+    TableType table;
+    for (KeyType key : keys)
+        table.insertWithoutSearch(key, KeyType(key));  // keys are unique and sorted
+
+    for (bool isFilterEnabled : { false, true }) {
+        table.setFilterEnabled(isFilterEnabled);
+        size_t found = 0;
+        Timer timer;
+        for (KeyType query : queries)
+            found += table.find(query) != table.end();
+        double findSeconds = timer.getSeconds();
+
+        std::printf("    %-26s filter %-3s %8.1f ns/find  (found %zu)", tableName, isFilterEnabled ? "on" : "off",
+            findSeconds * 1e9 / queries.size(), found);
+        if (isFilterEnabled)
+            std::printf("  filter %zu KB, false positive rate %.4f (expected %.4f)",
+                table.getFilter().getMemorySize() >> 10, table.getFilter().getFalsePositiveRate(),
+                table.getFilter().getExpectedFalsePositiveRate());
+        std::printf("\n");
+    }
+}
+
+int main(int argc, char** argv) {
+    size_t n = getSizeFromArgs(argc, argv, size_t(1) << 22);
+    std::vector<KeyType> keys = generateUniformKeys(n);
+    std::vector<KeyType> misses = generateUniformKeys(n, 4);
+    std::vector<KeyType> queries(keys.size());
+    std::default_random_engine randGen(5);
+    for (size_t i = 0; i < queries.size(); i++)
+        queries[i] = i % 10 == 0 ? keys[randGen() % keys.size()] : misses[randGen() % misses.size()];
+
+    std::printf("random keys (%zu), 90%% of searches miss:\n", keys.size());
+    runBenchmark<SortedTable<KeyType>>("SortedTable", keys, queries);
+    runBenchmark<HashTableSeparateChaining<KeyType>>("HashTableSeparateChaining", keys, queries);
+    return 0;
+}
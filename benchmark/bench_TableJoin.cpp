@@ -0,0 +1,92 @@
+#include "TableAlgorithms.h"
+#include "BenchmarkUtils.h"
+#include <cstdio>
+#include <thread>
+
+// compares join of two tables with the naive join (every element of one table is searched in another one)
+// hash tables are joined by 1, 2, 4, ... threads
+// usage: bench_TableJoin [number of keys in every table]
+
+template <class TableType>
+void fillTable(TableType& table, const std::vector<KeyType>& keys) {
+    for (KeyType key : keys)
+        table.insertWithoutSearch(key, KeyType(key));
+}
+
+template <class TableType>
+uint64_t naiveJoin(TableType& a, TableType& b) {
+    uint64_t sum = 0;
+    for (auto it = a.begin(); it != a.end(); ++it) {
+        auto found = b.find(it->first);
+        if (found != b.end())
+            sum += it->second + found->second;
+    }
+    return sum;
+}
+
+template <class TableType>
+void runHashTableBenchmark(const char* tableName, const std::vector<KeyType>& keysA,
+    const std::vector<KeyType>& keysB, size_t maxThreadsCount) {
+    TableType a, b;
+    fillTable(a, keysA);
+    fillTable(b, keysB);
+    Timer timer;
+    uint64_t naiveSum = naiveJoin(a, b);
+    std::printf("    %-26s naive %7.1f ms", tableName, timer.getSeconds() * 1e3);
+
+    for (size_t threadsCount = 1; threadsCount <= maxThreadsCount; threadsCount *= 2) {
+        std::vector<uint64_t> sums(threadsCount, 0);
+        timer.reset();
+        HashTablePartitionedMatcher<TableType, TableType> matcher(a, b, threadsCount);
+        matcher.run([&sums](size_t thread, KeyType, KeyType& elemA, KeyType* elemB) {
+            if (elemB != nullptr)
+                sums[thread] += elemA + *elemB;
+        });
+        double seconds = timer.getSeconds();
+        uint64_t sum = 0;
+        for (uint64_t threadSum : sums)
+            sum += threadSum;
+        std::printf("   join (%zu threads) %7.1f ms%s", threadsCount, seconds * 1e3,
+            sum == naiveSum ? "" : " (ERROR)");
+    }
+    std::printf("\n");
+}
+
+void runSortedTableBenchmark(const char* tableName, const std::vector<KeyType>& keysA,
+    const std::vector<KeyType>& keysB) {
+    SortedTable<KeyType> a, b;
+    fillTable(a, keysA);
+    fillTable(b, keysB);
+    Timer timer;
+    uint64_t naiveSum = naiveJoin(a, b);
+    double naiveSeconds = timer.getSeconds();
+
+    uint64_t sum = 0;
+    timer.reset();
+    join(a, b, [&sum](KeyType, KeyType& elemA, KeyType& elemB) {
+        sum += elemA + elemB;
+    });
+    std::printf("    %-26s naive %7.1f ms   join %7.1f ms%s\n", tableName, naiveSeconds * 1e3,
+        timer.getSeconds() * 1e3, sum == naiveSum ? "" : " (ERROR)");
+}
+
+int main(int argc, char** argv) {
+    size_t n = getSizeFromArgs(argc, argv, size_t(1) << 21);
+    size_t maxThreadsCount = std::max(std::thread::hardware_concurrency(), 1u);
+    std::vector<KeyType> keysA = generateUniformKeys(n, 1), keysB = generateUniformKeys(n, 2);
+    // a half of keys are common
+    std::copy(keysA.begin(), keysA.begin() + keysA.size() / 2, keysB.begin());
+    keysB = makeUniqueSorted(keysB);
+
+    std::printf("tables of the same size (%zu and %zu):\n", keysA.size(), keysB.size());
+    runHashTableBenchmark<HashTableOpenAddressing<KeyType>>("HashTableOpenAddressing", keysA, keysB,
+        maxThreadsCount);
+    runHashTableBenchmark<HashTableSeparateChaining<KeyType>>("HashTableSeparateChaining", keysA, keysB,
+        maxThreadsCount);
+    runSortedTableBenchmark("SortedTable", keysA, keysB);
+
+    std::vector<KeyType> smallKeysA(keysA.begin(), keysA.begin() + keysA.size() / 64);
+    std::printf("tables of different sizes (%zu and %zu):\n", smallKeysA.size(), keysB.size());
+    runSortedTableBenchmark("SortedTable (galloping)", smallKeysA, keysB);
+    return 0;
+}
@@ -0,0 +1,217 @@
+#include "UnsortedTable.h"
+#include "SortedTable.h"
+#include "HashTable.h"
+#include "TableTrace.h"
+#include "BenchmarkUtils.h"
+#include <atomic>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <new>
+#include <sstream>
+
+#ifdef __linux__
+#include <sys/resource.h>
+#include <sys/wait.h>
+#include <unistd.h>
+#endif
+
+// replays a trace of table operations against all tables
+// reports throughput, latency percentiles of every type of operation, peak RSS and allocations
+// on Linux every table is replayed in a separate process, so peak RSS is measured for one table
+// (it includes memory of the trace itself, which is the same for all tables)
+// usage:
+//     bench_TraceReplay <trace file>                        replays the trace
+//     bench_TraceReplay --record <trace file> [operations]  records a synthetic trace
+//     bench_TraceReplay                                     records a synthetic trace in memory and replays it
+
+// global operator new is replaced to count allocations
+std::atomic<size_t> allocationsCount(0);
+std::atomic<size_t> allocatedBytes(0);
+
+void* operator new(size_t size) {
+    allocationsCount++;
+    allocatedBytes += size;
+    void* ptr = std::malloc(size == 0 ? 1 : size);
+    if (ptr == nullptr)
+        throw std::bad_alloc();
+    return ptr;
+}
+
+void operator delete(void* ptr) noexcept {
+    std::free(ptr);
+}
+
+void operator delete(void* ptr, size_t) noexcept {
+    std::free(ptr);
+}
+
+// types of operations in the report, find and erase are split by their result
+enum ReplayOperation {
+    INSERT,
+    FIND_HIT,
+    FIND_MISS,
+    ERASE_HIT,
+    ERASE_MISS,
+    REPLAY_OPERATIONS_COUNT
+};
+
+const char* REPLAY_OPERATION_NAMES[REPLAY_OPERATIONS_COUNT] = {
+    "insert", "find (hit)", "find (miss)", "erase (hit)", "erase (miss)"
+};
+
+// synthetic load: keys are skewed to the beginning of range, so there are hits and misses
+// 30% of operations are insertions, 55% are searches and 15% are erasures
+void recordSyntheticTrace(std::ostream& ostr, size_t operationsCount) {
+    HashTableOpenAddressing<std::string> table;
+    TraceRecordingTable<HashTableOpenAddressing<std::string>> recordingTable(table, ostr);
+    std::default_random_engine randGen(1);
+    std::exponential_distribution<double> keyDist(4.0);
+    std::uniform_int_distribution<int> operationDist(0, 99);
+    std::uniform_int_distribution<size_t> valueSizeDist(0, 64);
+    KeyType range = KeyType(operationsCount / 2 + 1);
+    for (size_t i = 0; i < operationsCount; i++) {
+        KeyType key = KeyType(std::min(keyDist(randGen), 1.0) * range);
+        int operation = operationDist(randGen);
+        if (operation < 30)
+            recordingTable.insert(key, std::string(valueSizeDist(randGen), 'x'));
+        else if (operation < 85)
+            recordingTable.find(key);
+        else
+            recordingTable.erase(key);
+    }
+}
+
+size_t getPercentile(const std::vector<uint32_t>& sortedLatencies, double q) {
+    return sortedLatencies[std::min(sortedLatencies.size() - 1, size_t(q * sortedLatencies.size()))];
+}
+
+// peak resident set size of this process in KB, 0 if it is unknown
+long getPeakRss() {
+#ifdef __linux__
+    rusage usage;
+    if (getrusage(RUSAGE_SELF, &usage) == 0)
+        return usage.ru_maxrss;
+#endif
+    return 0;
+}
+
+template <class TableType>
+void replay(const char* tableName, const std::vector<TraceRecord>& records) {
+    // memory for latencies is allocated before replay, so it is not counted
+    std::vector<std::vector<uint32_t>> latencies(REPLAY_OPERATIONS_COUNT);
+    for (auto& opLatencies : latencies)
+        opLatencies.reserve(records.size());
+
+    TableType table;
+    size_t allocationsBefore = allocationsCount, bytesBefore = allocatedBytes;
+    size_t valuesAllocations = 0, valuesBytes = 0;
+    Timer total;
+    for (const TraceRecord& record : records) {
+        ReplayOperation operation;
+        std::chrono::steady_clock::time_point start;
+        switch (record.operation) {
+        case TraceOperation::INSERT: {
+            size_t allocations = allocationsCount, bytes = allocatedBytes;
+            std::string value(record.valueSize, 'x');
+            valuesAllocations += allocationsCount - allocations;
+            valuesBytes += allocatedBytes - bytes;
+            start = std::chrono::steady_clock::now();
+            table.insert(record.key, std::move(value));
+            operation = INSERT;
+            break;
+        }
+        case TraceOperation::FIND:
+            start = std::chrono::steady_clock::now();
+            operation = table.find(record.key) != table.end() ? FIND_HIT : FIND_MISS;
+            break;
+        default:
+            start = std::chrono::steady_clock::now();
+            operation = table.erase(record.key) ? ERASE_HIT : ERASE_MISS;
+            break;
+        }
+        auto finish = std::chrono::steady_clock::now();
+        latencies[operation].push_back(uint32_t(
+            std::chrono::duration_cast<std::chrono::nanoseconds>(finish - start).count()));
+    }
+    double seconds = total.getSeconds();
+    // values are created by replay, not by table
+    size_t allocations = allocationsCount - allocationsBefore - valuesAllocations;
+    size_t bytes = allocatedBytes - bytesBefore - valuesBytes;
+
+    std::printf("%s:\n", tableName);
+    std::printf("    throughput %.2f Mops/s, %zu elements at the end\n",
+        records.size() / seconds / 1e6, size_t(table.getSize()));
+    for (int operation = 0; operation < REPLAY_OPERATIONS_COUNT; operation++) {
+        std::vector<uint32_t>& opLatencies = latencies[operation];
+        if (opLatencies.empty())
+            continue;
+        std::sort(opLatencies.begin(), opLatencies.end());
+        std::printf("    %-13s %9zu ops   p50 %7zu ns   p99 %7zu ns   p999 %7zu ns\n",
+            REPLAY_OPERATION_NAMES[operation], opLatencies.size(), getPercentile(opLatencies, 0.5),
+            getPercentile(opLatencies, 0.99), getPercentile(opLatencies, 0.999));
+    }
+    std::printf("    allocations %zu (%.1f MB)", allocations, bytes / 1048576.0);
+    long peakRss = getPeakRss();
+    if (peakRss > 0)
+        std::printf(", peak RSS %.1f MB", peakRss / 1024.0);
+    std::printf("\n");
+    std::fflush(stdout);
+}
+
+// on Linux replay is run in a child process, so tables don't influence peak RSS of each other
+template <class TableType>
+void replayInSeparateProcess(const char* tableName, const std::vector<TraceRecord>& records) {
+#ifdef __linux__
+    std::fflush(stdout);
+    pid_t pid = fork();
+    if (pid == 0) {
+        replay<TableType>(tableName, records);
+        std::_Exit(0);
+    }
+    if (pid > 0) {
+        int status;
+        waitpid(pid, &status, 0);
+        return;
+    }
+#endif
+    replay<TableType>(tableName, records);
+}
+
+void replayAll(std::istream& istr) {
+    TraceReader reader(istr);
+    std::vector<TraceRecord> records = reader.readAll();
+    std::printf("trace of %zu operations\n", records.size());
+    replayInSeparateProcess<UnsortedTable<std::string>>("UnsortedTable", records);
+    replayInSeparateProcess<SortedTable<std::string>>("SortedTable", records);
+    replayInSeparateProcess<HashTableSeparateChaining<std::string>>("HashTableSeparateChaining", records);
+    replayInSeparateProcess<HashTableOpenAddressing<std::string>>("HashTableOpenAddressing", records);
+}
+
+int main(int argc, char** argv) {
+    try {
+        if (argc > 2 && std::strcmp(argv[1], "--record") == 0) {
+            std::ofstream file(argv[2], std::ios::binary);
+            recordSyntheticTrace(file, argc > 3 ? std::stoull(argv[3]) : size_t(1) << 20);
+            return 0;
+        }
+        if (argc > 1) {
+            std::ifstream file(argv[1], std::ios::binary);
+            if (!file) {
+                std::fprintf(stderr, "can't open %s\n", argv[1]);
+                return 1;
+            }
+            replayAll(file);
+            return 0;
+        }
+        std::stringstream trace;
+        recordSyntheticTrace(trace, size_t(1) << 16);
+        replayAll(trace);
+    }
+    catch (const std::exception& e) {
+        std::fprintf(stderr, "%s\n", e.what());
+        return 1;
+    }
+    return 0;
+}
@@ -0,0 +1,209 @@
+#pragma once
+#include "Table.h"
+#include "HashTable.h"
+#include <array>
+#include <memory>
+#include <optional>
+
+
+template <class ElemType, size_t N>
+class AdaptiveTableIterator;
+
+// class of an adaptive table
+// the first N elements are stored in the inline array (without heap allocations)
+// and are looked through linearly as in UnsortedTable
+// if there are more than N elements the table is promoted to HashTableOpenAddressing
+// if the number of elements becomes less than or equal to N/2 the table is demoted back
+// it is useful if there are a lot of small tables
+template <class ElemType, size_t N = 16>
+class AdaptiveTable : public Table<ElemType,
+    AdaptiveTableIterator<ElemType, N>,
+    AdaptiveTable<ElemType, N>> {
+
+    static_assert(N > 0, "Inline capacity of AdaptiveTable must be positive");
+
+public:
+
+    using iterator = AdaptiveTableIterator<ElemType, N>;
+
+    AdaptiveTable() = default;
+
+    AdaptiveTable(const AdaptiveTable& table) : inlineStorage(table.inlineStorage),
+        inlineSize(table.inlineSize),
+        hashTable(table.hashTable ? std::make_unique<HashTableType>(*table.hashTable) : nullptr) {}
+
+    AdaptiveTable(AdaptiveTable&& table) = default;
+
+    AdaptiveTable& operator=(AdaptiveTable table) {
+        std::swap(inlineStorage, table.inlineStorage);
+        std::swap(inlineSize, table.inlineSize);
+        std::swap(hashTable, table.hashTable);
+        return *this;
+    }
+
+    // search O(N) if the table is small and O(1) on the average otherwise
+    iterator find(const KeyType& key) {
+        if (isPromoted())
+            return iterator(hashTable->find(key));
+        size_t i = 0;
+        for (; i < inlineSize && inlineStorage[i].first != key; ++i);
+        return iterator(inlineStorage.data() + i);
+    }
+
+    // insertion O(1) on the average
+    // promotion O(N) is done once when the inline array is overflowed
+    iterator insertWithoutSearch(const KeyType& key, ElemType&& elem) {
+        if (!isPromoted() && inlineSize == N)
+            promote();
+        if (isPromoted())
+            return iterator(hashTable->insertWithoutSearch(key, std::move(elem)));
+        inlineStorage[inlineSize] = std::make_pair(key, std::move(elem));  // here we are moving key and elem
+        return iterator(inlineStorage.data() + inlineSize++);
+    }
+
+    // erasing O(1)
+    // demotion O(N) is done when the number of elements becomes N/2
+    // so insertions and erasures near the threshold do not repack the table every time
+    void eraseWithoutSearch(const iterator& pos) {
+        if (isPromoted()) {
+            hashTable->eraseWithoutSearch(*pos.hashIterator);
+            if (hashTable->getSize() <= N / 2)
+                demote();
+            return;
+        }
+        std::swap(*pos.inlineIterator, inlineStorage[inlineSize - 1]);
+        inlineStorage[--inlineSize] = std::pair<KeyType, ElemType>();  // free resources of erased element
+    }
+
+    void clear() {
+        hashTable.reset();
+        for (size_t i = 0; i < inlineSize; i++)
+            inlineStorage[i] = std::pair<KeyType, ElemType>();
+        inlineSize = 0;
+    }
+
+    size_t getSize() const {
+        return isPromoted() ? hashTable->getSize() : inlineSize;
+    }
+
+    bool isEmpty() const {
+        return getSize() == 0;
+    }
+
+    // true if elements are stored in the hash table
+    bool isPromoted() const {
+        return hashTable != nullptr;
+    }
+
+
+    iterator begin() {
+        if (isPromoted())
+            return iterator(hashTable->begin());
+        return iterator(inlineStorage.data());
+    }
+
+    iterator end() {
+        if (isPromoted())
+            return iterator(hashTable->end());
+        return iterator(inlineStorage.data() + inlineSize);
+    }
+
+protected:
+
+    using HashTableType = HashTableOpenAddressing<ElemType>;
+
+    std::array<std::pair<KeyType, ElemType>, N> inlineStorage;
+    size_t inlineSize = 0;
+
+    // it is allocated only if the table is promoted
+    std::unique_ptr<HashTableType> hashTable;
+
+    // capacity of the hash table is chosen so that 2N elements are stored without repack
+    static uint32_t getPromotedTableSizeDeg() {
+        uint32_t M = 1;
+        while ((size_t(1) << M) * 7 < 2 * N * 10)  // MAX_FILL_FACTOR = 0.7
+            M++;
+        return M;
+    }
+
+    // moves all elements from the inline array to the hash table
+    void promote() {
+        hashTable = std::make_unique<HashTableType>(getPromotedTableSizeDeg());
+        for (size_t i = 0; i < inlineSize; i++) {
+            hashTable->insertWithoutSearch(inlineStorage[i].first, std::move(inlineStorage[i].second));
+            inlineStorage[i] = std::pair<KeyType, ElemType>();
+        }
+        inlineSize = 0;
+    }
+
+    // moves all elements from the hash table to the inline array
+    void demote() {
+        std::unique_ptr<HashTableType> tmp;
+        std::swap(tmp, hashTable);
+        inlineSize = 0;
+        for (auto it = tmp->begin(); it != tmp->end(); ++it)
+            inlineStorage[inlineSize++] = std::move(*it);
+    }
+
+};
+
+
+// iterator for previous table
+// it is a pointer to the inline array or an iterator of the hash table
+template <class ElemType, size_t N>
+class AdaptiveTableIterator : public std::iterator<std::input_iterator_tag, std::pair<KeyType, ElemType>> {
+
+public:
+
+    // prefix
+    AdaptiveTableIterator& operator++() {
+        if (hashIterator)
+            ++(*hashIterator);
+        else
+            ++inlineIterator;
+        return *this;
+    }
+
+    // postfix
+    AdaptiveTableIterator operator++(int) {
+        AdaptiveTableIterator copy(*this);
+        ++(*this);
+        return copy;
+    }
+
+    std::pair<KeyType, ElemType>& operator*() const {
+        return hashIterator ? **hashIterator : *inlineIterator;
+    }
+
+    std::pair<KeyType, ElemType>* operator->() const {
+        return &(**this);
+    }
+
+    friend bool operator==(const AdaptiveTableIterator& it1, const AdaptiveTableIterator& it2) {
+        if (it1.hashIterator && it2.hashIterator)
+            return *it1.hashIterator == *it2.hashIterator;
+        return !it1.hashIterator && !it2.hashIterator && it1.inlineIterator == it2.inlineIterator;
+    }
+
+    friend bool operator!=(const AdaptiveTableIterator& it1, const AdaptiveTableIterator& it2) {
+        return !(it1 == it2);
+    }
+
+private:
+
+    friend class AdaptiveTable<ElemType, N>;
+
+    using HashTableIteratorType = typename HashTableOpenAddressing<ElemType>::iterator;
+
+    AdaptiveTableIterator(std::pair<KeyType, ElemType>* inlineIterator) :
+        inlineIterator(inlineIterator) {}
+
+    AdaptiveTableIterator(const HashTableIteratorType& hashIterator) :
+        hashIterator(hashIterator) {}
+
+    // iterator is used if the table is not promoted
+    std::pair<KeyType, ElemType>* inlineIterator = nullptr;
+    // iterator is used if the table is promoted
+    std::optional<HashTableIteratorType> hashIterator;
+
+};
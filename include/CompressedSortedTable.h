@@ -0,0 +1,328 @@
+#pragma once
+#include "Table.h"
+#include <algorithm>
+#include <iterator>
+
+
+template <class ElemType>
+class CompressedSortedTableIterator;
+
+// class of a sorted table with compressed keys
+// it is intended for large read-mostly tables with dense keys
+// keys are split into blocks of at most BLOCK_SIZE keys
+// every block stores its minimal key and differences key - minKey packed with the minimal bit width
+// maximal keys of blocks are stored uncompressed, so the block is found by binary search
+// values are stored in the separate array in the same order as keys
+// iterator gives std::pair<KeyType, ElemType&> because keys are not stored explicitly
+template <class ElemType>
+class CompressedSortedTable : public Table<ElemType,
+    CompressedSortedTableIterator<ElemType>,
+    CompressedSortedTable<ElemType>> {
+
+public:
+
+    using iterator = CompressedSortedTableIterator<ElemType>;
+
+    static const size_t BLOCK_SIZE = 128;
+
+    CompressedSortedTable() : packedKeys(PADDING_WORDS_COUNT, 0) {}
+
+    // builds the table from range of pairs sorted by unique keys O(n)
+    template <class InputIterator>
+    CompressedSortedTable(InputIterator first, InputIterator last) : packedKeys(PADDING_WORDS_COUNT, 0) {
+        std::vector<KeyType> keys;
+        for (; first != last; ++first) {
+            keys.push_back(first->first);
+            values.push_back(first->second);
+            if (keys.size() == BLOCK_SIZE) {
+                appendBlock(keys);
+                keys.clear();
+            }
+        }
+        if (!keys.empty())
+            appendBlock(keys);
+    }
+
+    // binary search O(log(n))
+    // the block is found by maximal keys, then the key is found in the block without unpacking
+    // it reads about log(BLOCK_SIZE) packed keys, it is faster than unpacking of the whole block
+    // even with vectorized unpacking (see bench_CompressedSortedTable)
+    iterator find(const KeyType& key) {
+        size_t block = std::lower_bound(blockMaxKeys.begin(), blockMaxKeys.end(), key) -
+            blockMaxKeys.begin();
+        if (block == blocks.size())
+            return end();
+        size_t left = 0, right = blocks[block].count;
+        while (left < right) {
+            size_t mid = (left + right) / 2;
+            if (getKey(blocks[block], mid) < key)
+                left = mid + 1;
+            else
+                right = mid;
+        }
+        if (getKey(blocks[block], left) != key)
+            return end();
+        return iterator(this, block, blocks[block].firstElem + left);
+    }
+
+    // insertion O(n)
+    // only one block is repacked, it is split into two blocks if it is overflowed
+    iterator insertWithoutSearch(const KeyType& key, ElemType&& elem) {
+        if (blocks.empty()) {
+            blocks.push_back(CompressedKeyBlock{ key, 0, 0, 0, 0 });
+            blockMaxKeys.push_back(key);
+        }
+        size_t block = std::lower_bound(blockMaxKeys.begin(), blockMaxKeys.end(), key) -
+            blockMaxKeys.begin();
+        if (block == blocks.size())
+            block--;
+
+        KeyType keys[BLOCK_SIZE + 1];
+        size_t count = unpackBlock(block, keys);
+        size_t pos = std::lower_bound(keys, keys + count, key) - keys;
+        std::copy_backward(keys + pos, keys + count, keys + count + 1);
+        keys[pos] = key;
+        count++;
+        values.insert(values.begin() + blocks[block].firstElem + pos, std::move(elem));  // here we are moving elem
+        for (size_t i = block + 1; i < blocks.size(); i++)
+            blocks[i].firstElem++;
+
+        if (count > BLOCK_SIZE) {
+            // if key is appended to the end of table then the first block is left full
+            // so sequential insertions give full blocks
+            bool isAppended = block + 1 == blocks.size() && pos + 1 == count;
+            size_t splitPos = isAppended ? BLOCK_SIZE : count / 2;
+            blocks.insert(blocks.begin() + block + 1, CompressedKeyBlock{ keys[splitPos], 0, 0,
+                uint32_t(blocks[block].firstWord + getWordsCount(blocks[block])),
+                uint32_t(blocks[block].firstElem + splitPos) });
+            blockMaxKeys.insert(blockMaxKeys.begin() + block + 1, keys[count - 1]);
+            packBlock(block + 1, keys + splitPos, count - splitPos);
+            count = splitPos;
+        }
+        packBlock(block, keys, count);
+
+        size_t cell = blocks[block].firstElem + pos;
+        if (pos >= count)
+            block++;
+        return iterator(this, block, cell);
+    }
+
+    // erasing O(n)
+    // only one block is repacked, it is removed if it becomes empty
+    void eraseWithoutSearch(const iterator& pos) {
+        size_t block = pos.block;
+        KeyType keys[BLOCK_SIZE];
+        size_t count = unpackBlock(block, keys);
+        std::copy(keys + (pos.cell - blocks[block].firstElem) + 1, keys + count,
+            keys + (pos.cell - blocks[block].firstElem));
+        count--;
+        values.erase(values.begin() + pos.cell);
+        for (size_t i = block + 1; i < blocks.size(); i++)
+            blocks[i].firstElem--;
+        packBlock(block, keys, count);
+        if (count == 0) {
+            blocks.erase(blocks.begin() + block);
+            blockMaxKeys.erase(blockMaxKeys.begin() + block);
+        }
+    }
+
+    void clear() {
+        std::vector<CompressedKeyBlock> tmpBlocks;
+        std::swap(tmpBlocks, blocks);
+        std::vector<KeyType> tmpBlockMaxKeys;
+        std::swap(tmpBlockMaxKeys, blockMaxKeys);
+        std::vector<uint32_t> tmpPackedKeys(PADDING_WORDS_COUNT, 0);
+        std::swap(tmpPackedKeys, packedKeys);
+        std::vector<ElemType> tmpValues;
+        std::swap(tmpValues, values);
+    }
+
+    size_t getSize() const {
+        return values.size();
+    }
+
+    bool isEmpty() const {
+        return values.empty();
+    }
+
+    // memory in bytes used for keys: packed keys, block headers and maximal keys of blocks
+    size_t getKeysMemorySize() const {
+        return packedKeys.size() * sizeof(uint32_t) + blocks.size() * sizeof(CompressedKeyBlock) +
+            blockMaxKeys.size() * sizeof(KeyType);
+    }
+
+
+    iterator begin() {
+        return iterator(this, 0, 0);
+    }
+
+    iterator end() {
+        return iterator(this, blocks.size(), values.size());
+    }
+
+protected:
+
+    friend class CompressedSortedTableIterator<ElemType>;
+
+    struct CompressedKeyBlock {
+        KeyType minKey;      // frame of reference, packed values are key - minKey
+        uint32_t bitWidth;   // number of bits of one packed value
+        uint32_t count;      // number of keys in block
+        uint32_t firstWord;  // position of block in packedKeys
+        uint32_t firstElem;  // position of the first value of block in values
+    };
+
+    std::vector<CompressedKeyBlock> blocks;
+    std::vector<KeyType> blockMaxKeys;
+    // packed keys of all blocks one after another
+    // the last words are always zero, so two words can be read from the beginning of any block
+    std::vector<uint32_t> packedKeys;
+    static const size_t PADDING_WORDS_COUNT = 2;
+    std::vector<ElemType> values;
+
+    // length of mashine word (32)
+    static const uint32_t W = sizeof(uint32_t) * 8;
+
+    static uint32_t getBitWidth(KeyType range) {
+        uint32_t bitWidth = 0;
+        for (; bitWidth < W && (uint64_t(range) >> bitWidth) != 0; bitWidth++);
+        return bitWidth;
+    }
+
+    static size_t getWordsCount(const CompressedKeyBlock& block) {
+        return (size_t(block.count) * block.bitWidth + W - 1) / W;
+    }
+
+    // it doesn't contain branches, so it is cheap to call it in binary search
+    KeyType getKey(const CompressedKeyBlock& block, size_t i) const {
+        size_t bit = i * block.bitWidth;
+        size_t word = block.firstWord + bit / W;
+        uint64_t window = packedKeys[word] | (uint64_t(packedKeys[word + 1]) << W);
+        uint64_t mask = (uint64_t(1) << block.bitWidth) - 1;
+        return block.minKey + KeyType((window >> (bit % W)) & mask);
+    }
+
+    // writes keys of block to keys (at least BLOCK_SIZE cells), returns their number
+    // it is used by insertion and erasing, find searches in packed keys without unpacking
+    // the loop has 32-bit indices, no branches and no dependencies between iterations, and keys don't alias
+    // packed words (__restrict), so it is vectorized with variable shifts (vpsrlvd, vpsllvd) if AVX2 is enabled,
+    // e.g. gcc -O3 -mavx2 -fopt-info-vec reports "loop vectorized using 32 byte vectors"; otherwise it is scalar
+    size_t unpackBlock(size_t block, KeyType* __restrict keys) const {
+        const CompressedKeyBlock& cur = blocks[block];
+        const uint32_t* words = packedKeys.data() + cur.firstWord;
+        uint32_t bitWidth = cur.bitWidth, count = cur.count;
+        KeyType minKey = cur.minKey;
+        uint32_t mask = uint32_t((uint64_t(1) << bitWidth) - 1);
+        for (uint32_t i = 0; i < count; i++) {
+            uint32_t bit = i * bitWidth;
+            uint32_t low = words[bit / W], high = words[bit / W + 1];
+            uint32_t shift = bit % W;
+            // high << (W - shift) is undefined for shift == 0, so high is shifted twice
+            keys[i] = minKey + (((low >> shift) | ((high << 1) << (W - 1 - shift))) & mask);
+        }
+        return count;
+    }
+
+    // replaces packed keys of block by count sorted keys
+    void packBlock(size_t block, const KeyType* keys, size_t count) {
+        CompressedKeyBlock& cur = blocks[block];
+        size_t oldWordsCount = getWordsCount(cur);
+        cur.count = uint32_t(count);
+        if (count > 0) {
+            cur.minKey = keys[0];
+            cur.bitWidth = getBitWidth(keys[count - 1] - keys[0]);
+            blockMaxKeys[block] = keys[count - 1];
+        }
+        uint32_t words[BLOCK_SIZE] = {};  // bitWidth <= W, so a block takes at most BLOCK_SIZE words
+        size_t wordsCount = getWordsCount(cur);
+        for (size_t i = 0; i < count && cur.bitWidth > 0; i++) {
+            size_t bit = i * cur.bitWidth;
+            uint64_t value = uint64_t(keys[i] - cur.minKey) << (bit % W);
+            words[bit / W] |= uint32_t(value);
+            if (bit % W + cur.bitWidth > W)
+                words[bit / W + 1] |= uint32_t(value >> W);
+        }
+        auto firstWord = packedKeys.begin() + cur.firstWord;
+        packedKeys.erase(firstWord, firstWord + oldWordsCount);
+        packedKeys.insert(packedKeys.begin() + cur.firstWord, words, words + wordsCount);
+        for (size_t i = block + 1; i < blocks.size(); i++)
+            blocks[i].firstWord = uint32_t(blocks[i].firstWord + wordsCount - oldWordsCount);
+    }
+
+    // adds block to the end, values of its keys must be already added
+    void appendBlock(const std::vector<KeyType>& keys) {
+        blocks.push_back(CompressedKeyBlock{ keys.front(), 0, 0,
+            uint32_t(packedKeys.size() - PADDING_WORDS_COUNT), uint32_t(values.size() - keys.size()) });
+        blockMaxKeys.push_back(keys.back());
+        packBlock(blocks.size() - 1, keys.data(), keys.size());
+    }
+
+};
+
+
+// iterator for previous table
+// iterator = block + number of element
+template <class ElemType>
+class CompressedSortedTableIterator : public std::iterator<std::input_iterator_tag,
+    std::pair<KeyType, ElemType&>> {
+
+public:
+
+    // it is returned by operator-> because pair is created on the fly
+    class ElemPointer {
+    public:
+        ElemPointer(const std::pair<KeyType, ElemType&>& elem) : elem(elem) {}
+        std::pair<KeyType, ElemType&>* operator->() {
+            return &elem;
+        }
+    private:
+        std::pair<KeyType, ElemType&> elem;
+    };
+
+    // prefix
+    CompressedSortedTableIterator& operator++() {
+        cell++;
+        if (cell == table->blocks[block].firstElem + table->blocks[block].count)
+            block++;
+        return *this;
+    }
+
+    // postfix
+    CompressedSortedTableIterator operator++(int) {
+        CompressedSortedTableIterator copy(*this);
+        ++(*this);
+        return copy;
+    }
+
+    std::pair<KeyType, ElemType&> operator*() const {
+        const auto& cur = table->blocks[block];
+        return std::pair<KeyType, ElemType&>(table->getKey(cur, cell - cur.firstElem), table->values[cell]);
+    }
+
+    ElemPointer operator->() const {
+        return ElemPointer(**this);
+    }
+
+    friend bool operator==(const CompressedSortedTableIterator& it1,
+        const CompressedSortedTableIterator& it2) {
+        return it1.cell == it2.cell && it1.table == it2.table;
+    }
+
+    friend bool operator!=(const CompressedSortedTableIterator& it1,
+        const CompressedSortedTableIterator& it2) {
+        return !(it1 == it2);
+    }
+
+private:
+
+    friend class CompressedSortedTable<ElemType>;
+
+    CompressedSortedTableIterator(CompressedSortedTable<ElemType>* table, size_t block, size_t cell) :
+        table(table), block(block), cell(cell) {}
+
+    // iterator knows about table
+    CompressedSortedTable<ElemType>* table;
+    size_t block;
+    size_t cell;
+
+};
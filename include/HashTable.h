@@ -1,28 +1,57 @@
 #pragma once
 #include "Table.h"
+#include "BloomFilter.h"
+#include <algorithm>
 #include <functional>
 #include <random>
 #include <list>
 
 
+// generator of parameters of hash functions, it is shared by all tables of a thread (splitmix64)
+// so a table doesn't keep a generator and doesn't call random_device
+// it is seeded by random_device once, seed gives the same parameters every time (e.g. in tests)
+class HashParameterGenerator {
+
+public:
+
+    static uint64_t next() {
+        uint64_t h = (getState() += 0x9E3779B97F4A7C15);
+        h = (h ^ (h >> 30)) * 0xBF58476D1CE4E5B9;
+        h = (h ^ (h >> 27)) * 0x94D049BB133111EB;
+        return h ^ (h >> 31);
+    }
+
+    static void seed(uint64_t value) {
+        getState() = value;
+    }
+
+private:
+
+    static uint64_t& getState() {
+        thread_local uint64_t state = (uint64_t(std::random_device()()) << 32) ^ std::random_device()();
+        return state;
+    }
+
+};
+
+
 // base class for hash tables
 // defines hash function
-// CellTypeDerived is the same as CellType in TableByArray
-template <class ElemType, class HashTableIteratorType, class DerivedType, class CellTypeDerived>
-class HashTable : public TableByArray<ElemType, HashTableIteratorType, DerivedType, CellTypeDerived> {
+// it monitors lengths of probe sequences (chains) looked through by find
+// if they are too long then table is rehashed with a new parameter of hash function,
+// so structured keys can't make table slow for a long time
+// the statistics are checked only by insertion (rehash in find would invalidate iterators),
+// so a table which is only searched is never reseeded
+// CellTypeDerived and Allocator are the same as CellType and Allocator in TableByArray
+template <class ElemType, class HashTableIteratorType, class DerivedType, class CellTypeDerived,
+    class Allocator = std::allocator<CellTypeDerived>>
+class HashTable : public TableByArray<ElemType, HashTableIteratorType, DerivedType, CellTypeDerived, Allocator> {
 
 public:
 
     // capacity = 2^M
     HashTable(uint32_t M = FIRST_TABLE_SIZE_DEG) :
-        M(M), TableByArrayType(getTableSize(M)), size(0) {
-        // it is an effective c++ code generating random value "a" of type uint32_t
-        // "a" is a parameter of hash function
-        std::random_device rd;
-        std::default_random_engine randGen(rd());
-        std::uniform_int_distribution<uint32_t> dist;
-        a = (uint64_t) dist(randGen);
-    }
+        M(M), TableByArrayType(getTableSize(M)), size(0), a(generateHashParameter()) {}
 
     uint32_t getSize() const {
         return size;
@@ -37,6 +66,37 @@ public:
         M = FIRST_TABLE_SIZE_DEG;
         storage.resize(getTableSize(M));
         size = 0;
+        resetProbeStats();
+    }
+
+    // the highest bitsCount bits of hash value, they don't depend on capacity of table
+    // so elements of several tables can be partitioned by hash function of one of them
+    uint32_t getHashPrefix(KeyType key, uint32_t bitsCount) const {
+        return bitsCount == 0 ? 0 : uint32_t((a * uint64_t(key)) >> (2 * W - bitsCount));
+    }
+
+    // statistics of searches since the last check of probe lengths
+    // length of probe sequence is the number of looked through elements or cells
+    double getAverageProbeLength() const {
+        return searchesCount == 0 ? 0 : double(probesCount) / searchesCount;
+    }
+
+    uint32_t getMaxProbeLength() const {
+        return maxProbeLength;
+    }
+
+    // number of rehashes with a new parameter of hash function
+    uint32_t getReseedsCount() const {
+        return reseedsCount;
+    }
+
+    // if it is disabled then parameter of hash function is never changed
+    void setAutoReseeding(bool isEnabled) {
+        isAutoReseeding = isEnabled;
+    }
+
+    bool isAutoReseedingEnabled() const {
+        return isAutoReseeding;
     }
 
 protected:
@@ -45,7 +105,7 @@ protected:
 
     uint32_t size = 0;
 
-    // random parameter of hash function
+    // random odd parameter of hash function
     uint64_t a;
 
     // capacity = 2^M
@@ -64,29 +124,81 @@ protected:
     const double COEF_INCREASE_SIZE_DEG = 1;  // increases table by 2^COEF_INCREASE_SIZE_DEG
                                               // new size = 2^(M + COEF_INCREASE_SIZE)
 
-    // universal hash function that can be computed quickly
+    // probe statistics
+    uint64_t probesCount = 0;
+    uint32_t searchesCount = 0;
+    uint32_t maxProbeLength = 0;
+    uint32_t reseedsCount = 0;
+    bool isAutoReseeding = true;
+    // stats are checked after this number of searches
+    // it is increased after reseeding, so rehashes take O(1) on the average even if keys are bad for any hash
+    uint32_t reseedCheckPeriod = MIN_RESEED_CHECK_PERIOD;
+
+    static const uint32_t MIN_SIZE_TO_RESEED = 64;          // small tables are never reseeded
+    static const uint32_t MIN_RESEED_CHECK_PERIOD = 128;
+    static constexpr double MAX_AVERAGE_PROBE_LENGTH = 8;   // if average length of probe sequence
+                                                            // is greater then table is reseeded
+    static const uint32_t MAX_PROBE_LENGTH_PER_DEG = 4;     // if any probe sequence is longer than
+                                                            // MAX_PROBE_LENGTH_PER_DEG * M then table is reseeded
+
+    // multiply-shift hash function, it is universal and can be computed quickly
+    // the high bits of 64-bit product are used, they depend on all bits of key
     uint32_t hash(KeyType key) {
-        return (uint32_t)(a * (uint64_t)key) >> (W - M);
+        return uint32_t((a * uint64_t(key)) >> (2 * W - M));
+    }
+
+    static uint64_t generateHashParameter() {
+        return HashParameterGenerator::next() | 1;  // "a" must be odd
+    }
+
+    // it is called by find of derived tables
+    void addProbeLength(uint32_t probeLength) {
+        probesCount += probeLength;
+        searchesCount++;
+        if (probeLength > maxProbeLength)
+            maxProbeLength = probeLength;
+    }
+
+    void resetProbeStats() {
+        probesCount = 0;
+        searchesCount = 0;
+        maxProbeLength = 0;
+    }
+
+    // it is called by insertion of derived tables, find only collects the statistics
+    // returns true if table should be rehashed with a new parameter of hash function
+    bool checkProbeStats() {
+        if (!isAutoReseeding || searchesCount < reseedCheckPeriod)
+            return false;
+        bool isReseedNeeded = size >= MIN_SIZE_TO_RESEED &&
+            (getAverageProbeLength() > MAX_AVERAGE_PROBE_LENGTH || maxProbeLength > MAX_PROBE_LENGTH_PER_DEG * M);
+        resetProbeStats();
+        if (isReseedNeeded) {
+            a = generateHashParameter();
+            reseedsCount++;
+            reseedCheckPeriod = std::max(reseedCheckPeriod, size);
+        }
+        return isReseedNeeded;
     }
 
 };
 
 
-template <class ElemType>
+template <class ElemType, class Allocator>
 class HashTableSeparateChainingIterator;
 
 // class for a hash table with separate chaining (cell is a list)
 // it needs of its own iterator class HashTableSeparateChainingIterator
-template <class ElemType>
+template <class ElemType, class Allocator = std::allocator<std::pair<KeyType, ElemType>>>
 class HashTableSeparateChaining : public HashTable<ElemType,
-    HashTableSeparateChainingIterator<ElemType>,
-    HashTableSeparateChaining<ElemType>,
-    std::list<std::pair<KeyType, ElemType>>> {
+    HashTableSeparateChainingIterator<ElemType, Allocator>,
+    HashTableSeparateChaining<ElemType, Allocator>,
+    std::list<std::pair<KeyType, ElemType>>, Allocator> {
 
     using HashTableType = HashTable<ElemType,
-        HashTableSeparateChainingIterator<ElemType>,
-        HashTableSeparateChaining<ElemType>,
-        std::list<std::pair<KeyType, ElemType>>>;
+        HashTableSeparateChainingIterator<ElemType, Allocator>,
+        HashTableSeparateChaining<ElemType, Allocator>,
+        std::list<std::pair<KeyType, ElemType>>, Allocator>;
 
 public:
 
@@ -94,12 +206,19 @@ public:
         HashTableType(M) {}
 
     // search O(1) on the average
+    // if the filter is enabled then most searches of missing keys don't touch chains
     iterator find(const KeyType& key) {
+        if (!filter.mayContain(key))
+            return end();
         uint32_t hashValue = hash(key);
         typename CellType::iterator it = storage[hashValue].begin();
-        for (; it != storage[hashValue].end() && it->first != key; ++it);
-        if (it == storage[hashValue].end())
+        uint32_t probeLength = 1;
+        for (; it != storage[hashValue].end() && it->first != key; ++it, ++probeLength);
+        addProbeLength(probeLength);
+        if (it == storage[hashValue].end()) {
+            filter.addFalsePositive();
             return end();
+        }
         return iterator(storage, hashValue, it);
     }
 
@@ -108,17 +227,47 @@ public:
         // if table is almost full then repack
         if (size + 1 > size_t(MAX_FILL_FACTOR * storage.size()))
             repack();
+        // if chains are too long then rehash with a new hash function
+        else if (checkProbeStats())
+            rehash(M);
         uint32_t hashValue = hash(key);
         storage[hashValue].push_front(std::make_pair(key, std::move(elem)));
         size++;
+        filter.add(key);
         return iterator(storage, hashValue, storage[hashValue].begin());
     }
 
     // erasing O(1) on the average
+    // the filter is rebuilt after many erasures, O(1) amortized
     void eraseWithoutSearch(const iterator& pos) {
         uint32_t hashValue = hash(pos->first);
         storage[hashValue].erase(pos.getListIterator());
         size--;
+        if (filter.addErasures(1))
+            rebuildFilter();
+    }
+
+    void clear() {
+        HashTableType::clear();
+        filter.clear();
+    }
+
+    // bloom filter which is checked by find before search, O(n) to enable
+    // it is useful if most of searched keys are missing in table
+    void setFilterEnabled(bool enabled) {
+        if (enabled)
+            rebuildFilter();
+        else
+            filter.disable();
+    }
+
+    bool isFilterEnabled() const {
+        return filter.isEnabled();
+    }
+
+    // statistics of the filter: size, false positive rate
+    const TableFilter& getFilter() const {
+        return filter;
     }
 
 
@@ -134,21 +283,37 @@ protected:
 
     // repack if table is almost filled
     void repack() {
-        M = uint32_t(M + COEF_INCREASE_SIZE_DEG);
-        std::vector<HashTableType::CellType> tmp(getTableSize(M));  // new storage
+        rehash(uint32_t(M + COEF_INCREASE_SIZE_DEG));
+    }
+
+    TableFilter filter;
+
+    // moves all elements to the new storage of capacity 2^newM
+    // the filter is rebuilt for the new capacity
+    void rehash(uint32_t newM) {
+        M = newM;
+        TableStorage<HashTableType::CellType, Allocator> tmp(getTableSize(M));  // new storage
         std::swap(tmp, storage);  // so tmp is old storage
-        // doing a lot of insertions
-        size = 0;
+        // nodes of lists are moved without reallocation
         for (size_t i = 0; i < tmp.size(); i++)
-            for (auto it = tmp[i].begin(); it != tmp[i].end(); it++)
-                insertWithoutSearch(std::move(it->first), std::move(it->second));
+            while (!tmp[i].empty()) {
+                auto& cell = storage[hash(tmp[i].front().first)];
+                cell.splice(cell.begin(), tmp[i], tmp[i].begin());
+            }
+        if (filter.isEnabled())
+            rebuildFilter();
+    }
+
+    // the filter has capacity of table before the next repack
+    void rebuildFilter() {
+        filter.rebuild(begin(), end(), size_t(MAX_FILL_FACTOR * storage.size()));
     }
 
 };
 
 
 // iterator for previous hash table
-template <class ElemType>
+template <class ElemType, class Allocator>
 class HashTableSeparateChainingIterator : public std::iterator<std::input_iterator_tag,
     std::pair<KeyType, ElemType>> {
 
@@ -189,11 +354,11 @@ public:
 
 private:
 
-    friend class HashTableSeparateChaining<ElemType>;
+    friend class HashTableSeparateChaining<ElemType, Allocator>;
 
     using CellType = std::list<std::pair<KeyType, ElemType>>;
 
-    HashTableSeparateChainingIterator(const std::reference_wrapper<std::vector<CellType>>& storage,
+    HashTableSeparateChainingIterator(const std::reference_wrapper<TableStorage<CellType, Allocator>>& storage,
         size_t cell, const typename CellType::iterator& listIterator) :
         storage(storage), cell(cell), listIterator(listIterator) {
         moveIteratorToExistingValueOrEnd();
@@ -205,7 +370,7 @@ private:
 
     // iterator knows about storage
     // iterator = cell of table + list iterator
-    std::reference_wrapper<std::vector<CellType>> storage;
+    std::reference_wrapper<TableStorage<CellType, Allocator>> storage;
     size_t cell;
     typename CellType::iterator listIterator;
 
@@ -219,7 +384,7 @@ private:
 };
 
 
-template <class ElemType>
+template <class ElemType, class Allocator>
 class HashTableOpenAddressingIterator;
 
 
@@ -233,19 +398,19 @@ struct HashTableOpenAddressingCellLabel {
 
 // class for a hash table with ope addressing (cell is a list)
 // it needs of its own iterator class HashTableOpenAddressingIterator
-template <class ElemType>
+template <class ElemType, class Allocator = std::allocator<std::pair<KeyType, ElemType>>>
 class HashTableOpenAddressing : public HashTable<ElemType,
-    HashTableOpenAddressingIterator<ElemType>,
-    HashTableOpenAddressing<ElemType>,
+    HashTableOpenAddressingIterator<ElemType, Allocator>,
+    HashTableOpenAddressing<ElemType, Allocator>,
     // all cells of hash table contain a label
     // it is necessary to determine if a cell with default key==uint32_t(0) is empty or not
     // or to determine a cell is deleted or not
-    std::pair<std::pair<KeyType, ElemType>, HashTableOpenAddressingCellLabel>> {
+    std::pair<std::pair<KeyType, ElemType>, HashTableOpenAddressingCellLabel>, Allocator> {
 
     using HashTableType = HashTable<ElemType,
-        HashTableOpenAddressingIterator<ElemType>,
-        HashTableOpenAddressing<ElemType>,
-        std::pair<std::pair<KeyType, ElemType>, HashTableOpenAddressingCellLabel>>;
+        HashTableOpenAddressingIterator<ElemType, Allocator>,
+        HashTableOpenAddressing<ElemType, Allocator>,
+        std::pair<std::pair<KeyType, ElemType>, HashTableOpenAddressingCellLabel>, Allocator>;
 
 public:
 
@@ -266,6 +431,7 @@ public:
                 storage[cell].first.first == key)) // or value is equal to key and element was not deleted
                 break;
         }
+        addProbeLength(uint32_t(i + 1));
         // if all table was looked through and needed cell or empty cell was not found
         // or if cell is free and element was not deleted (that is we didn't find key)
         if (i == storage.size() || (!storage[cell].second.is_cell_not_empty &&
@@ -282,6 +448,9 @@ public:
         // if table is almost full then repack
         if (size + 1 > size_t(MAX_FILL_FACTOR * storage.size()))
             repack();
+        // if probe sequences are too long then rehash with a new hash function
+        else if (checkProbeStats())
+            rehash(M);
         // looking for cell we can insert to
         uint32_t hashValue = hash(key);
         size_t cell = 0;
@@ -327,24 +496,27 @@ protected:
         return (hashValue + i * i) & (storage.size() - 1);
     }
 
-    // we add to the new table all elements: existing and deleted
     void repack() {
-        M = uint32_t(M + COEF_INCREASE_SIZE_DEG);
-        std::vector<HashTableType::CellType> tmp(getTableSize(M));
+        rehash(uint32_t(M + COEF_INCREASE_SIZE_DEG));
+    }
+
+    // moves all existing elements to the new storage of capacity 2^newM
+    // deleted elements are dropped, so probe sequences become shorter
+    void rehash(uint32_t newM) {
+        M = newM;
+        TableStorage<HashTableType::CellType, Allocator> tmp(getTableSize(M));
         std::swap(tmp, storage);
         size = 0;
         for (size_t i = 0; i < tmp.size(); i++)
-            if (tmp[i].second.is_cell_not_empty || tmp[i].second.is_element_was_deleted) {
-                iterator it = insertWithoutSearch(std::move(tmp[i].first.first), std::move(tmp[i].first.second));
-                storage[it.getCell()].second = tmp[i].second;
-            }
+            if (tmp[i].second.is_cell_not_empty)
+                insertWithoutSearch(std::move(tmp[i].first.first), std::move(tmp[i].first.second));
     }
 
 };
 
 
 // iterator for previous hash table
-template <class ElemType>
+template <class ElemType, class Allocator>
 class HashTableOpenAddressingIterator : public std::iterator<std::input_iterator_tag, std::pair<KeyType, ElemType>> {
 
 public:
@@ -383,11 +555,11 @@ public:
 
 private:
 
-    friend class HashTableOpenAddressing<ElemType>;
+    friend class HashTableOpenAddressing<ElemType, Allocator>;
 
     using CellType = std::pair<std::pair<KeyType, ElemType>, HashTableOpenAddressingCellLabel>;
 
-    HashTableOpenAddressingIterator(const std::reference_wrapper<std::vector<CellType>>& storage,
+    HashTableOpenAddressingIterator(const std::reference_wrapper<TableStorage<CellType, Allocator>>& storage,
         size_t cell) : storage(storage), cell(cell) {
         moveIteratorToExistingValueOrEnd();
     }
@@ -398,7 +570,7 @@ private:
 
     // iterator knows about storage
     // iteartor = cell of table
-    std::reference_wrapper<std::vector<CellType>> storage;
+    std::reference_wrapper<TableStorage<CellType, Allocator>> storage;
     size_t cell;
 
     void moveIteratorToExistingValueOrEnd() {
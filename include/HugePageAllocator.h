@@ -0,0 +1,109 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <new>
+
+#ifdef __linux__
+#include <sys/mman.h>
+#endif
+
+
+// allocator for very large tables, e.g. SortedTable<int, HugePageAllocator<int>>
+// random access to gigabytes of memory gives a lot of TLB misses if pages are small (4KB)
+// allocations larger than MIN_HUGE_PAGES_ALLOCATION_SIZE are aligned by 2MB and are backed by huge pages:
+// if UseHugeTlb then pages are taken from the pool of reserved huge pages (MAP_HUGETLB)
+// otherwise (or if the pool is empty) transparent huge pages are requested (MADV_HUGEPAGE)
+// if huge pages are not available, usual pages are used
+// smaller allocations and allocations on other systems than Linux are done by std::allocator
+template <class T, bool UseHugeTlb = false>
+class HugePageAllocator {
+
+public:
+
+    using value_type = T;
+
+    // rebind has to be defined because of non-type template parameter
+    template <class U>
+    struct rebind {
+        using other = HugePageAllocator<U, UseHugeTlb>;
+    };
+
+    static const size_t HUGE_PAGE_SIZE = size_t(1) << 21;                  // 2MB
+    static const size_t MIN_HUGE_PAGES_ALLOCATION_SIZE = HUGE_PAGE_SIZE;  // smaller allocations use
+                                                                          // std::allocator
+
+    HugePageAllocator() = default;
+
+    template <class U>
+    HugePageAllocator(const HugePageAllocator<U, UseHugeTlb>&) {}
+
+    T* allocate(size_t n) {
+#ifdef __linux__
+        if (isHugeAllocation(n)) {
+            size_t size = getAlignedSize(n);
+            void* ptr = MAP_FAILED;
+#ifdef MAP_HUGETLB
+            if (UseHugeTlb)
+                ptr = mmap(nullptr, size, PROT_READ | PROT_WRITE,
+                    MAP_PRIVATE | MAP_ANONYMOUS | MAP_HUGETLB, -1, 0);
+#endif
+            if (ptr == MAP_FAILED)
+                ptr = mapAligned(size);
+            return static_cast<T*>(ptr);
+        }
+#endif
+        return std::allocator<T>().allocate(n);
+    }
+
+    void deallocate(T* ptr, size_t n) {
+#ifdef __linux__
+        if (isHugeAllocation(n)) {
+            munmap(ptr, getAlignedSize(n));
+            return;
+        }
+#endif
+        std::allocator<T>().deallocate(ptr, n);
+    }
+
+    friend bool operator==(const HugePageAllocator&, const HugePageAllocator&) {
+        return true;
+    }
+
+    friend bool operator!=(const HugePageAllocator&, const HugePageAllocator&) {
+        return false;
+    }
+
+private:
+
+    static bool isHugeAllocation(size_t n) {
+        return n * sizeof(T) >= MIN_HUGE_PAGES_ALLOCATION_SIZE;
+    }
+
+    // size rounded up to the whole number of huge pages
+    static size_t getAlignedSize(size_t n) {
+        return (n * sizeof(T) + HUGE_PAGE_SIZE - 1) / HUGE_PAGE_SIZE * HUGE_PAGE_SIZE;
+    }
+
+#ifdef __linux__
+    // maps more memory than necessary and unmaps unaligned parts
+    // so the kernel can back the rest by transparent huge pages
+    static void* mapAligned(size_t size) {
+        void* ptr = mmap(nullptr, size + HUGE_PAGE_SIZE, PROT_READ | PROT_WRITE,
+            MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+        if (ptr == MAP_FAILED)
+            throw std::bad_alloc();
+        char* begin = static_cast<char*>(ptr);
+        char* alignedBegin = reinterpret_cast<char*>(
+            (reinterpret_cast<uintptr_t>(begin) + HUGE_PAGE_SIZE - 1) / HUGE_PAGE_SIZE * HUGE_PAGE_SIZE);
+        if (alignedBegin != begin)
+            munmap(begin, alignedBegin - begin);
+        munmap(alignedBegin + size, begin + HUGE_PAGE_SIZE - alignedBegin);
+#ifdef MADV_HUGEPAGE
+        madvise(alignedBegin, size, MADV_HUGEPAGE);  // it is only advice, error is not important
+#endif
+        return alignedBegin;
+    }
+#endif
+
+};
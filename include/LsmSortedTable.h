@@ -0,0 +1,405 @@
+#pragma once
+#include "Table.h"
+#include <algorithm>
+#include <limits>
+
+
+// cell of LsmSortedTable
+// tombstone means that element was erased, it hides the same key in older runs
+template <class ElemType>
+struct LsmSortedTableCell {
+    std::pair<KeyType, ElemType> elem;
+    bool isTombstone = false;
+};
+
+template <class ElemType>
+class LsmSortedTableIterator;
+
+// class of a write-optimized sorted table (log-structured merge)
+// new elements are inserted to the small sorted buffer
+// full buffer becomes an immutable sorted run, runs are merged when older run is not much larger than newer
+// so every element is merged O(log(n)) times and insertion is O(log(n)) amortized
+// merges are done incrementally: every insertion or erasing moves at most mergeStepsPerOperation cells
+// erasing inserts a tombstone to the buffer, tombstones are removed when they are merged to the oldest run
+// search looks through the buffer and runs from the newest to the oldest, the first found cell is the result
+// iterator merges all runs, so elements are iterated in ascending order of keys
+// any insertion or erasing invalidates all iterators
+template <class ElemType>
+class LsmSortedTable : public Table<ElemType,
+    LsmSortedTableIterator<ElemType>,
+    LsmSortedTable<ElemType>> {
+
+public:
+
+    using iterator = LsmSortedTableIterator<ElemType>;
+
+    static const size_t BUFFER_CAPACITY = 256;
+
+    LsmSortedTable() {
+        updateLevels();
+    }
+
+    LsmSortedTable(const LsmSortedTable& table) : buffer(table.buffer), runs(table.runs),
+        merge(table.merge), size(table.size), mergeStepsPerOperation(table.mergeStepsPerOperation) {
+        updateLevels();
+    }
+
+    LsmSortedTable& operator=(const LsmSortedTable& table) {
+        buffer = table.buffer;
+        runs = table.runs;
+        merge = table.merge;
+        size = table.size;
+        mergeStepsPerOperation = table.mergeStepsPerOperation;
+        updateLevels();
+        return *this;
+    }
+
+    // search O(log(n)^2), there are O(log(n)) runs
+    iterator find(const KeyType& key) {
+        for (size_t level = 0; level < levels.size(); level++) {
+            std::vector<Cell>& cells = *levels[level].cells;
+            auto it = lowerBoundCell(cells, levels[level].first, key);
+            if (it != cells.end() && it->elem.first == key) {
+                if (it->isTombstone)
+                    return end();
+                return iterator(this, level, it - cells.begin());
+            }
+        }
+        return end();
+    }
+
+    // iterator to the first element with key not less than given, O(log(n)^2)
+    // it is used for range lookups
+    iterator lowerBound(const KeyType& key) {
+        return iterator(this, key);
+    }
+
+    // insertion O(log(n)) amortized
+    iterator insertWithoutSearch(const KeyType& key, ElemType&& elem) {
+        doMergeWork();
+        if (buffer.size() >= BUFFER_CAPACITY)
+            flushBuffer();
+        auto it = lowerBoundCell(buffer, 0, key);
+        if (it != buffer.end() && it->elem.first == key) {  // tombstone of key is replaced
+            it->elem.second = std::move(elem);
+            it->isTombstone = false;
+        }
+        else {
+            it = buffer.insert(it, Cell{ std::make_pair(key, std::move(elem)), false });  // here we are moving key and elem
+        }
+        size++;
+        updateLevels();
+        return iterator(this, 0, it - buffer.begin());
+    }
+
+    // erasing O(log(n)) amortized
+    // if there are no runs then element is erased from the buffer
+    // otherwise a tombstone is inserted to the buffer
+    void eraseWithoutSearch(const iterator& pos) {
+        KeyType key = pos->first;
+        size--;
+        auto it = lowerBoundCell(buffer, 0, key);
+        if (runs.empty()) {
+            buffer.erase(it);
+            updateLevels();
+            return;
+        }
+        if (it != buffer.end() && it->elem.first == key) {
+            it->elem.second = ElemType();  // free resources of erased element
+            it->isTombstone = true;
+        }
+        else {
+            buffer.insert(it, Cell{ std::make_pair(key, ElemType()), true });
+        }
+        doMergeWork();
+        if (buffer.size() >= BUFFER_CAPACITY)
+            flushBuffer();
+        updateLevels();
+    }
+
+    // merges all runs into one, O(n)
+    // it makes search faster if table is not going to be changed
+    void compact() {
+        flushBuffer();
+        while (runs.size() > 1 || merge.isActive) {
+            if (!merge.isActive)
+                startMerge(runs.size() - 2);
+            while (merge.isActive)
+                mergeStep();
+        }
+        updateLevels();
+    }
+
+    // if steps == 0 then merges are done at once when they are necessary
+    // otherwise every operation moves at most steps cells, so operations take the similar time
+    void setMergeStepsPerOperation(size_t steps) {
+        mergeStepsPerOperation = steps;
+    }
+
+    size_t getRunsCount() const {
+        return runs.size();
+    }
+
+    void clear() {
+        std::vector<Cell> tmpBuffer;
+        std::swap(tmpBuffer, buffer);
+        std::vector<std::vector<Cell>> tmpRuns;
+        std::swap(tmpRuns, runs);
+        merge = Merge();
+        size = 0;
+        updateLevels();
+    }
+
+    size_t getSize() const {
+        return size;
+    }
+
+    bool isEmpty() const {
+        return size == 0;
+    }
+
+
+    iterator begin() {
+        return iterator(this, std::numeric_limits<KeyType>::min());
+    }
+
+    iterator end() {
+        return iterator(this, levels.size(), 0);
+    }
+
+protected:
+
+    friend class LsmSortedTableIterator<ElemType>;
+
+    using Cell = LsmSortedTableCell<ElemType>;
+
+    // sorted array of cells which is looked through by search, cells before first are ignored
+    struct Level {
+        std::vector<Cell>* cells;
+        size_t first;
+    };
+
+    // merge of runs[older] and runs[older + 1] in progress
+    // keys in output are less than keys in not merged parts of runs
+    struct Merge {
+        bool isActive = false;
+        size_t older = 0;
+        size_t olderPos = 0, newerPos = 0;
+        bool isTombstonesRemoved = false;
+        std::vector<Cell> output;
+    };
+
+    std::vector<Cell> buffer;
+    std::vector<std::vector<Cell>> runs;  // from the oldest to the newest
+    Merge merge;
+    size_t size = 0;
+    size_t mergeStepsPerOperation = 32;
+
+    // buffer, runs and parts of merge from the newest to the oldest
+    // it is rebuilt after every change
+    std::vector<Level> levels;
+
+    static const size_t MAX_RUNS_COUNT = 32;   // if there are more runs then merges are finished at once
+    static const size_t MERGE_SIZE_RATIO = 2;  // runs are merged if older run is not larger than
+                                               // MERGE_SIZE_RATIO * newer run
+
+    static typename std::vector<Cell>::iterator lowerBoundCell(std::vector<Cell>& cells, size_t first,
+        const KeyType& key) {
+        return std::lower_bound(cells.begin() + first, cells.end(), key,
+            [](const Cell& a, const KeyType& b) {
+            return a.elem.first < b;
+        });
+    }
+
+    void updateLevels() {
+        levels.clear();
+        levels.push_back(Level{ &buffer, 0 });
+        for (size_t i = runs.size(); i-- > 0;) {
+            if (merge.isActive && i == merge.older + 1) {
+                levels.push_back(Level{ &runs[i], merge.newerPos });
+            }
+            else if (merge.isActive && i == merge.older) {
+                levels.push_back(Level{ &runs[i], merge.olderPos });
+                levels.push_back(Level{ &merge.output, 0 });
+            }
+            else {
+                levels.push_back(Level{ &runs[i], 0 });
+            }
+        }
+    }
+
+    // buffer becomes the newest run
+    void flushBuffer() {
+        if (buffer.empty())
+            return;
+        if (runs.empty())  // there are no older elements, so tombstones are not necessary
+            buffer.erase(std::remove_if(buffer.begin(), buffer.end(),
+                [](const Cell& cell) { return cell.isTombstone; }), buffer.end());
+        runs.push_back(std::move(buffer));
+        buffer = std::vector<Cell>();
+        buffer.reserve(BUFFER_CAPACITY);
+    }
+
+    // returns index of older run of pair to merge or runs.size() if merge is not necessary
+    size_t findRunsToMerge() const {
+        for (size_t i = runs.size() - 1; i-- > 0;)
+            if (runs[i].size() <= MERGE_SIZE_RATIO * runs[i + 1].size())
+                return i;
+        return runs.size();
+    }
+
+    void startMerge(size_t older) {
+        merge.isActive = true;
+        merge.older = older;
+        merge.olderPos = merge.newerPos = 0;
+        merge.isTombstonesRemoved = older == 0;
+        merge.output.clear();
+        merge.output.reserve(runs[older].size() + runs[older + 1].size());
+    }
+
+    // moves one cell to output, the newer cell is taken if keys are equal
+    void mergeStep() {
+        std::vector<Cell>& older = runs[merge.older];
+        std::vector<Cell>& newer = runs[merge.older + 1];
+        if (merge.olderPos == older.size() && merge.newerPos == newer.size()) {
+            finishMerge();
+            return;
+        }
+        Cell* cell;
+        if (merge.newerPos < newer.size() && (merge.olderPos == older.size() ||
+            newer[merge.newerPos].elem.first <= older[merge.olderPos].elem.first)) {
+            if (merge.olderPos < older.size() && newer[merge.newerPos].elem.first == older[merge.olderPos].elem.first)
+                merge.olderPos++;  // older cell is hidden
+            cell = &newer[merge.newerPos++];
+        }
+        else {
+            cell = &older[merge.olderPos++];
+        }
+        if (!(merge.isTombstonesRemoved && cell->isTombstone))
+            merge.output.push_back(std::move(*cell));
+    }
+
+    void finishMerge() {
+        runs[merge.older] = std::move(merge.output);
+        runs.erase(runs.begin() + merge.older + 1);
+        merge = Merge();
+    }
+
+    // does mergeStepsPerOperation steps of merges
+    // merges are finished at once if mergeStepsPerOperation == 0 or if there are too many runs
+    void doMergeWork() {
+        size_t steps = mergeStepsPerOperation;
+        while (steps > 0 || mergeStepsPerOperation == 0 || runs.size() > MAX_RUNS_COUNT) {
+            if (!merge.isActive) {
+                size_t older = runs.size() < 2 ? runs.size() : findRunsToMerge();
+                if (older == runs.size())
+                    break;
+                startMerge(older);
+            }
+            mergeStep();
+            if (steps > 0)
+                steps--;
+        }
+    }
+
+};
+
+
+// iterator for previous table
+// iterator = level + cell of level
+// iterator got by find doesn't know positions in other levels, they are found by the first increment
+template <class ElemType>
+class LsmSortedTableIterator : public std::iterator<std::input_iterator_tag, std::pair<KeyType, ElemType>> {
+
+public:
+
+    // prefix
+    LsmSortedTableIterator& operator++() {
+        KeyType key = (**this).first;
+        if (cursors.empty()) {
+            for (const auto& level : table->levels)
+                cursors.push_back(std::upper_bound(level.cells->begin() + level.first, level.cells->end(), key,
+                    [](const KeyType& a, const LsmSortedTableCell<ElemType>& b) {
+                    return a < b.elem.first;
+                }) - level.cells->begin());
+        }
+        else {
+            skipKey(key);
+        }
+        moveIteratorToExistingValueOrEnd();
+        return *this;
+    }
+
+    // postfix
+    LsmSortedTableIterator operator++(int) {
+        LsmSortedTableIterator copy(*this);
+        ++(*this);
+        return copy;
+    }
+
+    std::pair<KeyType, ElemType>& operator*() const {
+        return (*table->levels[level].cells)[cell].elem;
+    }
+
+    std::pair<KeyType, ElemType>* operator->() const {
+        return &(**this);
+    }
+
+    friend bool operator==(const LsmSortedTableIterator& it1, const LsmSortedTableIterator& it2) {
+        return it1.level == it2.level && it1.cell == it2.cell && it1.table == it2.table;
+    }
+
+    friend bool operator!=(const LsmSortedTableIterator& it1, const LsmSortedTableIterator& it2) {
+        return !(it1 == it2);
+    }
+
+private:
+
+    friend class LsmSortedTable<ElemType>;
+
+    // iterator to the given cell
+    LsmSortedTableIterator(LsmSortedTable<ElemType>* table, size_t level, size_t cell) :
+        table(table), level(level), cell(cell) {}
+
+    // iterator to the first element with key not less than given
+    LsmSortedTableIterator(LsmSortedTable<ElemType>* table, const KeyType& key) : table(table) {
+        for (const auto& level : table->levels)
+            cursors.push_back(LsmSortedTable<ElemType>::lowerBoundCell(*level.cells, level.first, key) -
+                level.cells->begin());
+        moveIteratorToExistingValueOrEnd();
+    }
+
+    // iterator knows about table
+    LsmSortedTable<ElemType>* table;
+    size_t level = 0;
+    size_t cell = 0;
+    // positions in all levels, the current cell is the cell with minimal key in the newest level
+    std::vector<size_t> cursors;
+
+    // moves cursors which point to key
+    void skipKey(const KeyType& key) {
+        for (size_t i = 0; i < cursors.size(); i++)
+            if (cursors[i] < table->levels[i].cells->size() && (*table->levels[i].cells)[cursors[i]].elem.first == key)
+                cursors[i]++;
+    }
+
+    // chooses minimal key, tombstones are skipped
+    void moveIteratorToExistingValueOrEnd() {
+        while (true) {
+            level = table->levels.size();
+            cell = 0;
+            for (size_t i = 0; i < cursors.size(); i++) {
+                const auto& cells = *table->levels[i].cells;
+                if (cursors[i] < cells.size() && (level == table->levels.size() ||
+                    cells[cursors[i]].elem.first < (**this).first)) {
+                    level = i;
+                    cell = cursors[i];
+                }
+            }
+            if (level == table->levels.size() || !(*table->levels[level].cells)[cell].isTombstone)
+                return;
+            skipKey((**this).first);
+        }
+    }
+
+};
@@ -0,0 +1,493 @@
+#pragma once
+#include "Table.h"
+#include "HashTable.h"
+#include <algorithm>
+#include <iterator>
+
+
+// tables with several values per key (multimaps)
+// values of one key are stored contiguously, so all of them are got by one search and a sequential scan
+// insert never rejects a value, it is appended after other values of the key
+// equalRange(key) returns the range of values of key, count(key) returns their number
+// append(key, first, last) appends several values at once
+// erase(key) erases all values of key and returns their number
+// eraseWithoutSearch(it) erases one value, order of other values of the key is kept
+
+
+// class of a sorted multimap table
+// values of one key are adjacent, they are in order of insertion
+// iterator for such table is just std::vector::iterator
+template <class ElemType, class Allocator = std::allocator<std::pair<KeyType, ElemType>>>
+class SortedMultiTable : public TableByArray<ElemType,
+    typename TableStorage<std::pair<KeyType, ElemType>, Allocator>::iterator,
+    SortedMultiTable<ElemType, Allocator>, std::pair<KeyType, ElemType>, Allocator> {
+
+public:
+
+    // iterator to the first value of key, O(log(n))
+    iterator find(const KeyType& key) {
+        iterator it = lowerBound(key);
+        return it != end() && it->first == key ? it : end();
+    }
+
+    // O(log(n))
+    std::pair<iterator, iterator> equalRange(const KeyType& key) {
+        return std::make_pair(lowerBound(key), upperBound(key));
+    }
+
+    // O(log(n))
+    size_t count(const KeyType& key) {
+        return upperBound(key) - lowerBound(key);
+    }
+
+    iterator insert(const KeyType& key, const ElemType& elem) {
+        ElemType copy = elem;
+        return insert(key, std::move(copy));
+    }
+
+    // insertion after the last value of key O(n)
+    iterator insert(const KeyType& key, ElemType&& elem) {
+        return storage.insert(upperBound(key), std::make_pair(key, std::move(elem)));
+    }
+
+    // the same as insert, values are never rejected
+    iterator insertWithoutSearch(const KeyType& key, const ElemType& elem) {
+        return insert(key, elem);
+    }
+
+    iterator insertWithoutSearch(const KeyType& key, ElemType&& elem) {
+        return insert(key, std::move(elem));
+    }
+
+    // appends values [first, last) after the last value of key by one shift of elements O(n + k)
+    template <class ValueIterator>
+    void append(const KeyType& key, ValueIterator first, ValueIterator last) {
+        size_t cell = upperBound(key) - begin();
+        size_t count = std::distance(first, last);
+        storage.insert(begin() + cell, count, std::make_pair(key, ElemType()));
+        for (size_t i = cell; first != last; ++first, ++i)
+            storage[i].second = *first;
+    }
+
+    // erases all values of key O(n), returns their number
+    size_t erase(const KeyType& key) {
+        auto range = equalRange(key);
+        size_t count = range.second - range.first;
+        storage.erase(range.first, range.second);
+        return count;
+    }
+
+    // erasing of one value O(n)
+    void eraseWithoutSearch(const iterator& pos) {
+        storage.erase(pos);
+    }
+
+
+    iterator begin() {
+        return storage.begin();
+    }
+
+    iterator end() {
+        return storage.end();
+    }
+
+protected:
+
+    iterator lowerBound(const KeyType& key) {
+        return std::lower_bound(begin(), end(), key,
+            [](const std::pair<KeyType, ElemType>& a, const KeyType& b) {
+            return a.first < b;
+        });
+    }
+
+    iterator upperBound(const KeyType& key) {
+        return std::upper_bound(begin(), end(), key,
+            [](const KeyType& a, const std::pair<KeyType, ElemType>& b) {
+            return a < b.first;
+        });
+    }
+
+};
+
+
+template <class ElemType, class Allocator>
+class HashMultiTableIterator;
+
+// slot of HashMultiTable: a key and a group of its values in the arena
+struct HashMultiTableSlot {
+    KeyType key = 0;
+    uint32_t offset = 0;    // cell of the first value in the arena
+    uint32_t count = 0;     // number of values
+    uint32_t capacity = 0;  // number of cells reserved for the group
+    HashTableOpenAddressingCellLabel label;
+};
+
+// class of a hash multimap table
+// slots are stored as in HashTableOpenAddressing, a slot points to a group of values in the shared arena
+// if a group is full then it is moved to the end of the arena with doubled capacity,
+// so appending is O(1) amortized, the old cells of group become a hole
+// the arena is compacted when holes take more than a half of it
+template <class ElemType, class Allocator = std::allocator<std::pair<KeyType, ElemType>>>
+class HashMultiTable : public HashTable<ElemType,
+    HashMultiTableIterator<ElemType, Allocator>,
+    HashMultiTable<ElemType, Allocator>, HashMultiTableSlot, Allocator> {
+
+    using HashTableType = HashTable<ElemType,
+        HashMultiTableIterator<ElemType, Allocator>,
+        HashMultiTable<ElemType, Allocator>, HashMultiTableSlot, Allocator>;
+
+public:
+
+    HashMultiTable(uint32_t M = HashTableType::FIRST_TABLE_SIZE_DEG) :
+        HashTableType(M) {}
+
+    // iterator to the first value of key, O(1) on the average
+    iterator find(const KeyType& key) {
+        return iterator(storage, arena, findSlot(key), 0);
+    }
+
+    // values of key are contiguous in the arena, O(1) on the average
+    std::pair<iterator, iterator> equalRange(const KeyType& key) {
+        size_t slot = findSlot(key);
+        if (slot == storage.size())
+            return std::make_pair(end(), end());
+        return std::make_pair(iterator(storage, arena, slot, 0), iterator(storage, arena, slot, storage[slot].count));
+    }
+
+    // O(1) on the average
+    size_t count(const KeyType& key) {
+        size_t slot = findSlot(key);
+        return slot == storage.size() ? 0 : storage[slot].count;
+    }
+
+    iterator insert(const KeyType& key, const ElemType& elem) {
+        ElemType copy = elem;
+        return insert(key, std::move(copy));
+    }
+
+    // insertion after the last value of key O(1) amortized
+    iterator insert(const KeyType& key, ElemType&& elem) {
+        size_t slot = findOrInsertSlot(key);
+        reserve(slot, 1);
+        HashMultiTableSlot& s = storage[slot];
+        arena[s.offset + s.count] = std::make_pair(key, std::move(elem));
+        valuesCount++;
+        return iterator(storage, arena, slot, s.count++);
+    }
+
+    // the same as insert, values are never rejected
+    iterator insertWithoutSearch(const KeyType& key, const ElemType& elem) {
+        return insert(key, elem);
+    }
+
+    iterator insertWithoutSearch(const KeyType& key, ElemType&& elem) {
+        return insert(key, std::move(elem));
+    }
+
+    // appends values [first, last) after the last value of key, the group is moved once at most
+    // O(k) amortized
+    template <class ValueIterator>
+    void append(const KeyType& key, ValueIterator first, ValueIterator last) {
+        size_t count = std::distance(first, last);
+        if (count == 0)
+            return;
+        size_t slot = findOrInsertSlot(key);
+        reserve(slot, count);
+        HashMultiTableSlot& s = storage[slot];
+        for (; first != last; ++first)
+            arena[s.offset + s.count++] = std::make_pair(key, *first);
+        valuesCount += count;
+    }
+
+    // erases all values of key O(number of values), returns their number
+    size_t erase(const KeyType& key) {
+        size_t slot = findSlot(key);
+        if (slot == storage.size())
+            return 0;
+        size_t count = storage[slot].count;
+        eraseSlot(slot);
+        return count;
+    }
+
+    // erasing of one value O(number of values of key)
+    void eraseWithoutSearch(const iterator& pos) {
+        HashMultiTableSlot& s = storage[pos.getSlot()];
+        if (s.count == 1) {
+            eraseSlot(pos.getSlot());
+            return;
+        }
+        auto first = arena.begin() + s.offset;
+        std::move(first + pos.getPosition() + 1, first + s.count, first + pos.getPosition());
+        first[--s.count] = std::pair<KeyType, ElemType>();  // free resources of erased value
+        valuesCount--;
+    }
+
+    void clear() {
+        HashTableType::clear();
+        TableStorage<std::pair<KeyType, ElemType>, Allocator> tmp;
+        std::swap(tmp, arena);
+        valuesCount = 0;
+        holesCount = 0;
+    }
+
+    // number of values
+    size_t getSize() const {
+        return valuesCount;
+    }
+
+    bool isEmpty() const {
+        return valuesCount == 0;
+    }
+
+    size_t getKeysCount() const {
+        return size;
+    }
+
+
+    iterator begin() {
+        return iterator(storage, arena, 0, 0);
+    }
+
+    iterator end() {
+        return iterator(storage, arena, storage.size(), 0);
+    }
+
+protected:
+
+    // values of all keys, groups and holes
+    TableStorage<std::pair<KeyType, ElemType>, Allocator> arena;
+    size_t valuesCount = 0;
+    size_t holesCount = 0;  // cells of the arena which don't belong to any group
+
+    static const size_t MIN_HOLES_TO_COMPACT = 64;
+
+    // returns slot of key or storage.size(), the same probe sequence as in HashTableOpenAddressing
+    size_t findSlot(const KeyType& key) {
+        uint32_t hashValue = hash(key);
+        size_t i = 0;
+        for (; i < storage.size(); ++i) {
+            size_t slot = getProbeSequenceElem(hashValue, i);
+            if (!storage[slot].label.is_element_was_deleted &&
+                (!storage[slot].label.is_cell_not_empty || storage[slot].key == key)) {
+                addProbeLength(uint32_t(i + 1));
+                return storage[slot].label.is_cell_not_empty ? slot : storage.size();
+            }
+        }
+        addProbeLength(uint32_t(i));
+        return storage.size();
+    }
+
+    // returns slot of key, an empty group is created if key is not in table
+    size_t findOrInsertSlot(const KeyType& key) {
+        size_t slot = findSlot(key);
+        if (slot != storage.size())
+            return slot;
+        // if table is almost full then repack
+        if (size + 1 > size_t(MAX_FILL_FACTOR * storage.size()))
+            repack();
+        // if probe sequences are too long then rehash with a new hash function
+        else if (checkProbeStats())
+            rehash(M);
+        HashMultiTableSlot s;
+        s.key = key;
+        s.offset = uint32_t(arena.size());
+        s.label = HashTableOpenAddressingCellLabel(true, false);
+        size++;
+        return placeSlot(s);
+    }
+
+    // puts slot to the first cell of its probe sequence which is not filled
+    size_t placeSlot(const HashMultiTableSlot& s) {
+        uint32_t hashValue = hash(s.key);
+        size_t i = 0;
+        for (; storage[getProbeSequenceElem(hashValue, i)].label.is_cell_not_empty; ++i) {
+            if (i == storage.size()) {  // empty cell was not found
+                repack();
+                return placeSlot(s);
+            }
+        }
+        size_t slot = getProbeSequenceElem(hashValue, i);
+        storage[slot] = s;
+        return slot;
+    }
+
+    // makes room for "count" more values in the group, the group is moved to the end of the arena if needed
+    void reserve(size_t slot, size_t count) {
+        HashMultiTableSlot& s = storage[slot];
+        if (s.count + count <= s.capacity)
+            return;
+        size_t newCapacity = std::max<size_t>(s.count + count, 2 * s.capacity);
+        if (s.offset + s.capacity == arena.size()) {  // the group is the last one, it grows in place
+            arena.resize(s.offset + newCapacity);
+            s.capacity = uint32_t(newCapacity);
+            return;
+        }
+        // old cells of the group would become a hole, so the arena is compacted instead of moving
+        // if holes would take more than a half of it; the group keeps newCapacity in the new arena
+        size_t newHolesCount = holesCount + s.capacity;
+        if (newHolesCount > MIN_HOLES_TO_COMPACT && 2 * newHolesCount > arena.size() + newCapacity) {
+            compact(slot, newCapacity);
+            return;
+        }
+        size_t newOffset = arena.size();
+        arena.resize(newOffset + newCapacity);
+        for (size_t i = 0; i < s.count; i++) {
+            arena[newOffset + i] = std::move(arena[s.offset + i]);
+            arena[s.offset + i] = std::pair<KeyType, ElemType>();
+        }
+        holesCount = newHolesCount;
+        s.offset = uint32_t(newOffset);
+        s.capacity = uint32_t(newCapacity);
+    }
+
+    void eraseSlot(size_t slot) {
+        HashMultiTableSlot& s = storage[slot];
+        for (size_t i = 0; i < s.count; i++)
+            arena[s.offset + i] = std::pair<KeyType, ElemType>();  // free resources of erased values
+        if (s.offset + s.capacity == arena.size())  // the group is the last one
+            arena.resize(s.offset);
+        else
+            holesCount += s.capacity;
+        valuesCount -= s.count;
+        size--;
+        s.label = HashTableOpenAddressingCellLabel(false, true);
+        if (holesCount > MIN_HOLES_TO_COMPACT && 2 * holesCount > arena.size())
+            compact();
+    }
+
+    // moves all groups to the new arena without holes and reserved cells, O(n)
+    void compact() {
+        compact(storage.size(), 0);
+    }
+
+    // the same but the group of reservedSlot is placed last with reservedCapacity cells
+    void compact(size_t reservedSlot, size_t reservedCapacity) {
+        size_t arenaSize = valuesCount;
+        if (reservedSlot < storage.size())
+            arenaSize += reservedCapacity - storage[reservedSlot].count;
+        TableStorage<std::pair<KeyType, ElemType>, Allocator> tmp(arenaSize);
+        std::swap(tmp, arena);
+        size_t offset = 0;
+        auto moveGroup = [&](HashMultiTableSlot& s, size_t capacity) {
+            std::move(tmp.begin() + s.offset, tmp.begin() + s.offset + s.count, arena.begin() + offset);
+            s.offset = uint32_t(offset);
+            s.capacity = uint32_t(capacity);
+            offset += capacity;
+        };
+        for (size_t slot = 0; slot < storage.size(); slot++)
+            if (slot != reservedSlot && storage[slot].label.is_cell_not_empty)
+                moveGroup(storage[slot], storage[slot].count);
+        if (reservedSlot < storage.size())
+            moveGroup(storage[reservedSlot], reservedCapacity);
+        holesCount = 0;
+    }
+
+    size_t getProbeSequenceElem(uint32_t hashValue, size_t i) {
+        return (hashValue + i * i) & (storage.size() - 1);
+    }
+
+    void repack() {
+        rehash(uint32_t(M + COEF_INCREASE_SIZE_DEG));
+    }
+
+    // moves slots to the new storage of capacity 2^newM, the arena is not changed
+    // deleted slots are dropped, so probe sequences become shorter
+    void rehash(uint32_t newM) {
+        M = newM;
+        TableStorage<HashMultiTableSlot, Allocator> tmp(getTableSize(M));
+        std::swap(tmp, storage);
+        for (size_t i = 0; i < tmp.size(); i++)
+            if (tmp[i].label.is_cell_not_empty)
+                placeSlot(tmp[i]);
+    }
+
+};
+
+
+// iterator for previous table
+// iterator = slot + pointer to value in its group, the end of group is cached,
+// so scanning of values of key doesn't look at the slot
+template <class ElemType, class Allocator>
+class HashMultiTableIterator : public std::iterator<std::input_iterator_tag, std::pair<KeyType, ElemType>> {
+
+public:
+
+    // prefix
+    HashMultiTableIterator& operator++() {
+        if (++value == groupEnd) {
+            slot++;
+            moveIteratorToExistingValueOrEnd();
+        }
+        return *this;
+    }
+
+    // postfix
+    HashMultiTableIterator operator++(int) {
+        HashMultiTableIterator copy(*this);
+        ++(*this);
+        return copy;
+    }
+
+    std::pair<KeyType, ElemType>& operator*() const {
+        return *value;
+    }
+
+    std::pair<KeyType, ElemType>* operator->() const {
+        return value;
+    }
+
+    // values of different groups have different addresses, end has null value
+    friend bool operator==(const HashMultiTableIterator& it1, const HashMultiTableIterator& it2) {
+        return it1.value == it2.value && it1.slot == it2.slot;
+    }
+
+    friend bool operator!=(const HashMultiTableIterator& it1, const HashMultiTableIterator& it2) {
+        return !(it1 == it2);
+    }
+
+private:
+
+    friend class HashMultiTable<ElemType, Allocator>;
+
+    using SlotsType = TableStorage<HashMultiTableSlot, Allocator>;
+    using ArenaType = TableStorage<std::pair<KeyType, ElemType>, Allocator>;
+
+    // position == count of values of slot means the first value of the next group
+    HashMultiTableIterator(SlotsType& slots, ArenaType& arena, size_t slot, size_t position) :
+        slots(slots), arena(arena), slot(slot) {
+        if (slot < slots.size() && slots[slot].label.is_cell_not_empty && position >= slots[slot].count)
+            this->slot++;
+        moveIteratorToExistingValueOrEnd();
+        if (this->slot == slot)
+            value += position;
+    }
+
+    size_t getSlot() const {
+        return slot;
+    }
+
+    size_t getPosition() const {
+        return value - &arena.get()[slots.get()[slot].offset];
+    }
+
+    std::reference_wrapper<SlotsType> slots;
+    std::reference_wrapper<ArenaType> arena;
+    size_t slot;
+    std::pair<KeyType, ElemType>* value = nullptr;
+    std::pair<KeyType, ElemType>* groupEnd = nullptr;
+
+    // moves to the first value of the first not empty group starting from slot
+    void moveIteratorToExistingValueOrEnd() {
+        SlotsType& s = slots.get();
+        while (slot < s.size() && (!s[slot].label.is_cell_not_empty || s[slot].count == 0))
+            slot++;
+        if (slot < s.size()) {
+            value = arena.get().data() + s[slot].offset;
+            groupEnd = value + s[slot].count;
+        }
+        else {
+            value = groupEnd = nullptr;
+        }
+    }
+
+};
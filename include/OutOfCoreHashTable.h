@@ -0,0 +1,683 @@
+#pragma once
+#include "Table.h"
+#include "HashTable.h"
+#include "BloomFilter.h"
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <memory>
+#include <optional>
+#include <stdexcept>
+#include <string>
+#include <type_traits>
+#include <vector>
+
+
+// serialization of elements to partition files of OutOfCoreHashTable
+// it is defined for trivially copyable types, strings and vectors of trivially copyable types
+// other types of elements need a specialization with the same static functions
+template <class ElemType, class Enable = void>
+struct SpillSerializer;
+
+template <class ElemType>
+struct SpillSerializer<ElemType, std::enable_if_t<std::is_trivially_copyable<ElemType>::value>> {
+
+    static void write(std::ostream& ostr, const ElemType& elem) {
+        ostr.write(reinterpret_cast<const char*>(&elem), sizeof(ElemType));
+    }
+
+    static void read(std::istream& istr, ElemType& elem) {
+        istr.read(reinterpret_cast<char*>(&elem), sizeof(ElemType));
+    }
+
+};
+
+template <>
+struct SpillSerializer<std::string> {
+
+    static void write(std::ostream& ostr, const std::string& elem) {
+        uint32_t size = uint32_t(elem.size());
+        ostr.write(reinterpret_cast<const char*>(&size), sizeof(size));
+        ostr.write(elem.data(), size);
+    }
+
+    static void read(std::istream& istr, std::string& elem) {
+        uint32_t size = 0;
+        istr.read(reinterpret_cast<char*>(&size), sizeof(size));
+        elem.resize(istr ? size : 0);
+        istr.read(&elem[0], elem.size());
+    }
+
+};
+
+template <class T, class Allocator>
+struct SpillSerializer<std::vector<T, Allocator>, std::enable_if_t<std::is_trivially_copyable<T>::value>> {
+
+    static void write(std::ostream& ostr, const std::vector<T, Allocator>& elem) {
+        uint32_t size = uint32_t(elem.size());
+        ostr.write(reinterpret_cast<const char*>(&size), sizeof(size));
+        ostr.write(reinterpret_cast<const char*>(elem.data()), size * sizeof(T));
+    }
+
+    static void read(std::istream& istr, std::vector<T, Allocator>& elem) {
+        uint32_t size = 0;
+        istr.read(reinterpret_cast<char*>(&size), sizeof(size));
+        elem.resize(istr ? size : 0);
+        istr.read(reinterpret_cast<char*>(elem.data()), elem.size() * sizeof(T));
+    }
+
+};
+
+
+// hash table of a partition of OutOfCoreHashTable
+// it is written to the file as an image of cells with parameter of hash function and capacity,
+// so the loaded table has the same layout and its elements are iterated in the same order
+template <class ElemType>
+class OutOfCorePartitionTable : public HashTableOpenAddressing<ElemType> {
+
+public:
+
+    using HashTableOpenAddressing<ElemType>::HashTableOpenAddressing;
+
+    // O(capacity), a label of every cell and elements of filled cells are written
+    void writeImage(std::ostream& ostr) const {
+        ostr.write(reinterpret_cast<const char*>(&M), sizeof(M));
+        ostr.write(reinterpret_cast<const char*>(&a), sizeof(a));
+        for (const CellType& cell : storage) {
+            char label = cell.second.is_cell_not_empty ? FILLED_CELL :
+                cell.second.is_element_was_deleted ? DELETED_CELL : EMPTY_CELL;
+            ostr.write(&label, sizeof(label));
+            if (label == FILLED_CELL) {
+                ostr.write(reinterpret_cast<const char*>(&cell.first.first), sizeof(KeyType));
+                SpillSerializer<ElemType>::write(ostr, cell.first.second);
+            }
+        }
+    }
+
+    // O(capacity), the table is replaced by the image
+    void readImage(std::istream& istr) {
+        uint32_t newM = 0;
+        istr.read(reinterpret_cast<char*>(&newM), sizeof(newM));
+        istr.read(reinterpret_cast<char*>(&a), sizeof(a));
+        if (!istr || newM >= W)
+            throw std::runtime_error("Partition file is corrupted");
+        M = newM;
+        storage.assign(getTableSize(M), CellType());
+        size = 0;
+        for (CellType& cell : storage) {
+            char label = EMPTY_CELL;
+            istr.read(&label, sizeof(label));
+            if (label == FILLED_CELL) {
+                istr.read(reinterpret_cast<char*>(&cell.first.first), sizeof(KeyType));
+                SpillSerializer<ElemType>::read(istr, cell.first.second);
+                size++;
+            }
+            cell.second = HashTableOpenAddressingCellLabel(label == FILLED_CELL, label == DELETED_CELL);
+            if (!istr)
+                throw std::runtime_error("Partition file is corrupted");
+        }
+        resetProbeStats();
+    }
+
+protected:
+
+    static constexpr char EMPTY_CELL = 0;
+    static constexpr char FILLED_CELL = 1;
+    static constexpr char DELETED_CELL = 2;
+
+};
+
+
+template <class ElemType>
+class OutOfCoreHashTableIterator;
+
+// class of a hash table with a memory budget
+// keys are partitioned by extendible hashing: the highest bits of multiply-shift hash (as in HashTable)
+// select an entry of directory, the entry points to a partition
+// a partition is split in two if it has more elements than 1/16 of budget can hold
+// every partition is a hash table if it is loaded or a file in spill directory otherwise
+// if estimated memory usage exceeds the budget then the least recently used partitions are spilled
+// a spilled partition has an in-memory bloom filter, so most negative lookups don't read the disk
+// new elements of a spilled partition are appended to its file by buffered sequential writes
+// without loading it, the partition is loaded by the first successful search
+// a partition is spilled as an image of its cells, so it has the same order of elements after loading
+// iterators are resolved by key if the partition was spilled or loaded since they were got,
+// so they stay valid until the next insertion or erasure as for other hash tables
+// partitions are not split if the directory, descriptors of partitions and filters would take
+// more than 1/2 of budget, then they are just overfilled
+// memory of elements outside of cells (e.g. characters of strings) is not counted
+template <class ElemType>
+class OutOfCoreHashTable : public Table<ElemType,
+    OutOfCoreHashTableIterator<ElemType>,
+    OutOfCoreHashTable<ElemType>> {
+
+public:
+
+    using iterator = OutOfCoreHashTableIterator<ElemType>;
+
+    static constexpr size_t DEFAULT_MEMORY_BUDGET = size_t(1) << 28;  // 256 MB
+
+    // files are stored in a new subdirectory of baseDirectory (temporary directory by default)
+    // it is created by the first spill and removed with the table
+    OutOfCoreHashTable(size_t memoryBudget = DEFAULT_MEMORY_BUDGET, const std::string& baseDirectory = "") :
+        memoryBudget(memoryBudget), baseDirectory(baseDirectory), a(generateHashParameter()) {
+        reset();
+    }
+
+    // the table owns its files
+    OutOfCoreHashTable(const OutOfCoreHashTable&) = delete;
+    OutOfCoreHashTable& operator=(const OutOfCoreHashTable&) = delete;
+
+    ~OutOfCoreHashTable() {
+        removeSpillDirectory();
+    }
+
+    // search O(1) on the average if the partition is loaded or the key is rejected by the filter
+    // otherwise the partition is read from the disk, O(size of partition)
+    iterator find(const KeyType& key) {
+        size_t p = getPartition(key);
+        if (!partitions[p].table) {
+            if (!partitions[p].filter.mayContain(key)) {
+                filterSkipsCount++;
+                return end();
+            }
+            load(p);
+        }
+        touch(p);
+        auto it = partitions[p].table->find(key);
+        if (it == partitions[p].table->end())
+            return end();
+        return iterator(this, p, it);
+    }
+
+    // insertion O(1) on the average
+    // the element is appended to the buffer of a spilled partition, the buffer is written when it is full
+    // split of overflowed partition takes O(size of partition)
+    iterator insertWithoutSearch(const KeyType& key, ElemType&& elem) {
+        size_t p = getPartition(key);
+        Partition& part = partitions[p];
+        size++;
+        part.size++;
+        if (!part.table) {
+            part.appendBuffer.emplace_back(key, std::move(elem));
+            bufferedCount++;
+            if (part.appendBuffer.size() == APPEND_BUFFER_SIZE)
+                flushAppendBuffer(p);
+        }
+        else {
+            part.table->insertWithoutSearch(key, std::move(elem));
+            part.isDirty = true;
+            loadedCount++;
+        }
+        part.filter.add(key);
+        if (part.size > getMaxPartitionSize() && canSplit(part)) {
+            load(p);
+            split(p);
+            p = getPartition(key);
+        }
+        touch(p);
+        evictIfNeeded(p);
+        return iterator(this, p, key);
+    }
+
+    // erasing O(1) on the average, iterator is got by find so the partition is loaded
+    // partitions are never merged
+    void eraseWithoutSearch(const iterator& pos) {
+        resolve(pos);
+        Partition& part = partitions[pos.partition];
+        part.table->eraseWithoutSearch(*pos.partitionIterator);
+        part.isDirty = true;
+        part.isFilterStale = true;
+        part.size--;
+        size--;
+        loadedCount--;
+    }
+
+    void clear() {
+        removeSpillDirectory();
+        reset();
+    }
+
+    size_t getSize() const {
+        return size;
+    }
+
+    bool isEmpty() const {
+        return size == 0;
+    }
+
+    // estimated memory of loaded partitions, append buffers, filters, directory and partitions in bytes
+    size_t getMemoryUsage() const {
+        return loadedCount * LOADED_ELEM_MEMORY + bufferedCount * sizeof(std::pair<KeyType, ElemType>) +
+            filtersMemory + getDirectoryMemory(directory.size(), partitions.size());
+    }
+
+    size_t getMemoryBudget() const {
+        return memoryBudget;
+    }
+
+    size_t getPartitionsCount() const {
+        return partitions.size();
+    }
+
+    size_t getSpilledPartitionsCount() const {
+        size_t count = 0;
+        for (const Partition& part : partitions)
+            count += !part.table;
+        return count;
+    }
+
+    // number of loads of spilled partitions
+    size_t getLoadsCount() const {
+        return loadsCount;
+    }
+
+    // number of searches in spilled partitions which were rejected by bloom filters
+    size_t getFilterSkipsCount() const {
+        return filterSkipsCount;
+    }
+
+
+    iterator begin() {
+        iterator it(this, 0, KeyType());
+        moveIteratorToExistingValueOrEnd(it);
+        return it;
+    }
+
+    iterator end() {
+        return iterator(this, END_PARTITION, KeyType());
+    }
+
+protected:
+
+    friend class OutOfCoreHashTableIterator<ElemType>;
+
+    using HashTableType = OutOfCorePartitionTable<ElemType>;
+    using SerializerType = SpillSerializer<ElemType>;
+
+    struct Partition {
+        std::unique_ptr<HashTableType> table;  // it is nullptr if the partition is spilled
+        size_t size = 0;  // including elements in the file and in the append buffer
+        // the file is an image of the table written by the last spill and records appended after it
+        bool hasImage = false;
+        size_t fileSize = 0;  // number of appended records in the file
+        std::vector<std::pair<KeyType, ElemType>> appendBuffer;
+        // it is used only if the partition is spilled but keys are added all the time
+        // so the filter is rebuilt by spill only after erasures or if it is overfilled
+        BloomFilter filter;
+        bool isFilterStale = true;
+        uint32_t localDepth = 0;
+        uint64_t lastAccess = 0;
+        bool isDirty = false;  // true if the file doesn't match the loaded table
+    };
+
+    static constexpr size_t END_PARTITION = size_t(-1);
+    static constexpr size_t IO_BUFFER_SIZE = size_t(1) << 20;
+    static constexpr size_t APPEND_BUFFER_SIZE = 1024;  // in elements
+    static constexpr size_t MIN_MAX_PARTITION_SIZE = 256;
+    static constexpr size_t MIN_LOADED_PARTITIONS = 16;  // a partition takes at most 1/16 of budget
+    static constexpr uint32_t MAX_DEPTH = 24;
+    static constexpr size_t MAX_METADATA_MEMORY_PART = 2;  // 1/2 of budget
+    // a false positive loads the whole partition, so filters are more precise than by default (0.05%)
+    static constexpr uint32_t FILTER_BITS_PER_KEY = 16;
+    static constexpr double MAX_FILTER_FALSE_POSITIVE_RATE = 0.002;
+    // a cell of HashTableOpenAddressing, there are 1.4-2.9 cells per element
+    static constexpr size_t LOADED_ELEM_MEMORY =
+        2 * sizeof(std::pair<std::pair<KeyType, ElemType>, HashTableOpenAddressingCellLabel>);
+
+    size_t memoryBudget;
+    std::string baseDirectory;
+    std::string spillDirectory;  // it is empty until the first spill
+
+    // random odd parameter of hash function
+    uint64_t a;
+
+    // extendible hashing: directory has 2^globalDepth entries
+    // a partition with localDepth d is pointed by 2^(globalDepth - d) entries with the same prefix
+    std::vector<size_t> directory;
+    uint32_t globalDepth = 0;
+    std::vector<Partition> partitions;
+
+    size_t size = 0;
+    size_t loadedCount = 0;  // elements of loaded partitions
+    size_t bufferedCount = 0;  // elements in append buffers
+    size_t filtersMemory = 0;
+    uint64_t accessClock = 0;
+    // it is increased when partitions are spilled, loaded or split
+    // iterators with another version are resolved by key
+    uint64_t layoutVersion = 0;
+    size_t loadsCount = 0;
+    size_t filterSkipsCount = 0;
+
+    std::vector<char> ioBuffer;  // it is allocated by the first spill
+
+    static uint64_t generateHashParameter() {
+        return HashParameterGenerator::next() | 1;  // "a" must be odd
+    }
+
+    // multiply-shift hash, the highest globalDepth bits of 64-bit product
+    size_t getPartition(KeyType key) const {
+        return directory[globalDepth == 0 ? 0 : size_t((a * uint64_t(key)) >> (64 - globalDepth))];
+    }
+
+    // bit of hash which splits partition of local depth "depth"
+    uint32_t getSplitBit(KeyType key, uint32_t depth) const {
+        return uint32_t((a * uint64_t(key)) >> (63 - depth)) & 1;
+    }
+
+    size_t getMaxPartitionSize() const {
+        return std::max(MIN_MAX_PARTITION_SIZE, memoryBudget / (LOADED_ELEM_MEMORY * MIN_LOADED_PARTITIONS));
+    }
+
+    // memory of the directory and descriptors of partitions
+    static size_t getDirectoryMemory(size_t directorySize, size_t partitionsCount) {
+        return directorySize * sizeof(size_t) + partitionsCount * sizeof(Partition);
+    }
+
+    // the new partition has a filter of minimal size
+    bool canSplit(const Partition& part) const {
+        if (part.localDepth == MAX_DEPTH)
+            return false;
+        size_t directorySize = part.localDepth == globalDepth ? 2 * directory.size() : directory.size();
+        return getDirectoryMemory(directorySize, partitions.size() + 1) + filtersMemory +
+            BloomFilter().getMemorySize() <= memoryBudget / MAX_METADATA_MEMORY_PART;
+    }
+
+    // capacity of hash table is chosen so that "count" elements are inserted without repack
+    static uint32_t getTableSizeDeg(size_t count) {
+        uint32_t M = 3;
+        while ((size_t(1) << M) * 7 < (count + 1) * 10)  // MAX_FILL_FACTOR = 0.7
+            M++;
+        return M;
+    }
+
+    void reset() {
+        directory.assign(1, 0);
+        globalDepth = 0;
+        partitions.clear();
+        partitions.emplace_back();
+        partitions[0].table = std::make_unique<HashTableType>();
+        size = loadedCount = bufferedCount = 0;
+        filtersMemory = partitions[0].filter.getMemorySize();
+        layoutVersion++;
+    }
+
+    void touch(size_t p) {
+        partitions[p].lastAccess = ++accessClock;
+    }
+
+    std::string getPartitionPath(size_t p) {
+        if (spillDirectory.empty()) {
+            std::filesystem::path base = baseDirectory.empty() ?
+                std::filesystem::temp_directory_path() : std::filesystem::path(baseDirectory);
+            std::filesystem::path dir;
+            do {
+                dir = base / ("out_of_core_table_" + std::to_string(generateHashParameter()));
+            } while (!std::filesystem::create_directories(dir));
+            spillDirectory = dir.string();
+        }
+        return spillDirectory + "/partition_" + std::to_string(p) + ".bin";
+    }
+
+    void removeSpillDirectory() {
+        if (spillDirectory.empty())
+            return;
+        std::error_code error;
+        std::filesystem::remove_all(spillDirectory, error);
+        spillDirectory.clear();
+    }
+
+    void openFile(std::fstream& file, size_t p, std::ios::openmode mode) {
+        ioBuffer.resize(IO_BUFFER_SIZE);
+        file.rdbuf()->pubsetbuf(ioBuffer.data(), ioBuffer.size());
+        file.open(getPartitionPath(p), mode | std::ios::binary);
+        if (!file)
+            throw std::runtime_error("Cannot open partition file " + getPartitionPath(p));
+    }
+
+    static void writeRecord(std::ostream& ostr, KeyType key, const ElemType& elem) {
+        ostr.write(reinterpret_cast<const char*>(&key), sizeof(key));
+        SerializerType::write(ostr, elem);
+    }
+
+    // appends buffered elements to the file of spilled partition, O(size of buffer)
+    void flushAppendBuffer(size_t p) {
+        Partition& part = partitions[p];
+        std::fstream file;
+        openFile(file, p, std::ios::out | std::ios::app);
+        for (auto& record : part.appendBuffer)
+            writeRecord(file, record.first, record.second);
+        if (!file.flush())
+            throw std::runtime_error("Cannot write partition file");
+        part.fileSize += part.appendBuffer.size();
+        bufferedCount -= part.appendBuffer.size();
+        part.appendBuffer.clear();
+        part.appendBuffer.shrink_to_fit();
+    }
+
+    // reads the file of spilled partition, O(size of partition)
+    // the table is dirty if elements were appended, so the next spill writes a new image
+    void load(size_t p) {
+        Partition& part = partitions[p];
+        if (part.table)
+            return;
+        auto table = std::make_unique<HashTableType>(getTableSizeDeg(part.size));
+        if (part.hasImage || part.fileSize > 0) {
+            std::fstream file;
+            openFile(file, p, std::ios::in);
+            if (part.hasImage)
+                table->readImage(file);
+            for (size_t i = 0; i < part.fileSize; i++) {
+                KeyType key;
+                ElemType elem;
+                file.read(reinterpret_cast<char*>(&key), sizeof(key));
+                SerializerType::read(file, elem);
+                if (!file)
+                    throw std::runtime_error("Partition file is corrupted");
+                table->insertWithoutSearch(key, std::move(elem));
+            }
+        }
+        for (auto& record : part.appendBuffer)
+            table->insertWithoutSearch(record.first, std::move(record.second));
+        part.isDirty = part.fileSize > 0 || !part.appendBuffer.empty();
+        bufferedCount -= part.appendBuffer.size();
+        part.appendBuffer.clear();
+        part.appendBuffer.shrink_to_fit();
+        part.table = std::move(table);
+        loadedCount += part.size;
+        layoutVersion++;
+        loadsCount++;
+        touch(p);
+        evictIfNeeded(p);
+    }
+
+    // writes image of the partition to its file if it was changed and rebuilds the filter if needed
+    // O(capacity of partition)
+    void spill(size_t p) {
+        Partition& part = partitions[p];
+        if (part.isDirty) {
+            std::fstream file;
+            openFile(file, p, std::ios::out | std::ios::trunc);
+            part.table->writeImage(file);
+            if (!file.flush())
+                throw std::runtime_error("Cannot write partition file");
+            part.hasImage = true;
+            part.fileSize = 0;
+            part.isDirty = false;
+        }
+        if (part.isFilterStale || part.filter.getExpectedFalsePositiveRate() > MAX_FILTER_FALSE_POSITIVE_RATE) {
+            filtersMemory -= part.filter.getMemorySize();
+            // the filter has a reserve for appended elements
+            part.filter = BloomFilter(std::min(getMaxPartitionSize(), 2 * part.size + MIN_MAX_PARTITION_SIZE),
+                FILTER_BITS_PER_KEY);
+            for (auto it = part.table->begin(); it != part.table->end(); ++it)
+                part.filter.add(it->first);
+            filtersMemory += part.filter.getMemorySize();
+            part.isFilterStale = false;
+        }
+        part.table.reset();
+        loadedCount -= part.size;
+        layoutVersion++;
+    }
+
+    // spills the least recently used partitions except the current one while budget is exceeded
+    void evictIfNeeded(size_t current) {
+        while (getMemoryUsage() > memoryBudget) {
+            size_t victim = END_PARTITION;
+            for (size_t p = 0; p < partitions.size(); p++)
+                if (p != current && partitions[p].table &&
+                    (victim == END_PARTITION || partitions[p].lastAccess < partitions[victim].lastAccess))
+                    victim = p;
+            if (victim != END_PARTITION)
+                spill(victim);
+            else if (bufferedCount > 0) {
+                for (size_t p = 0; p < partitions.size(); p++)
+                    if (!partitions[p].appendBuffer.empty())
+                        flushAppendBuffer(p);
+            }
+            else
+                return;
+        }
+    }
+
+    // splits the loaded partition by the next bit of hash, O(size of partition)
+    // the directory is doubled if local depth of partition is equal to global depth
+    void split(size_t p) {
+        if (partitions[p].localDepth == globalDepth) {
+            std::vector<size_t> newDirectory(directory.size() * 2);
+            for (size_t i = 0; i < newDirectory.size(); i++)
+                newDirectory[i] = directory[i / 2];
+            std::swap(directory, newDirectory);
+            globalDepth++;
+        }
+        uint32_t depth = partitions[p].localDepth;
+        size_t q = partitions.size();
+        partitions.emplace_back();
+        filtersMemory += partitions[q].filter.getMemorySize();
+        std::unique_ptr<HashTableType> old;
+        std::swap(old, partitions[p].table);
+        for (size_t part : { p, q }) {
+            partitions[part].table = std::make_unique<HashTableType>(getTableSizeDeg(old->getSize() / 2));
+            partitions[part].size = 0;
+            partitions[part].localDepth = depth + 1;
+            partitions[part].isDirty = true;
+            partitions[part].isFilterStale = true;
+            partitions[part].lastAccess = partitions[p].lastAccess;
+        }
+        for (auto it = old->begin(); it != old->end(); ++it) {
+            Partition& part = partitions[getSplitBit(it->first, depth) ? q : p];
+            part.table->insertWithoutSearch(it->first, std::move(it->second));
+            part.size++;
+        }
+        for (size_t i = 0; i < directory.size(); i++)
+            if (directory[i] == p && (i >> (globalDepth - depth - 1) & 1))
+                directory[i] = q;
+        layoutVersion++;
+    }
+
+    // finds the partition and the element by key of iterator if layout was changed
+    void resolve(const iterator& it) {
+        if (it.version == layoutVersion && it.partitionIterator)
+            return;
+        size_t p = getPartition(it.key);
+        load(p);
+        touch(p);
+        it.partition = p;
+        it.partitionIterator = partitions[p].table->find(it.key);
+        it.version = layoutVersion;
+    }
+
+    // moves iterator to the first element of the first nonempty partition starting from it.partition
+    // partitions are loaded on the way
+    void moveIteratorToExistingValueOrEnd(iterator& it) {
+        for (size_t p = it.partition; p < partitions.size(); p++) {
+            if (partitions[p].size == 0)
+                continue;
+            load(p);
+            touch(p);
+            it.partition = p;
+            it.partitionIterator = partitions[p].table->begin();
+            it.key = (*it.partitionIterator)->first;
+            it.version = layoutVersion;
+            return;
+        }
+        it.partition = END_PARTITION;
+        it.partitionIterator.reset();
+    }
+
+};
+
+
+// iterator for previous table
+// it is a partition, an iterator of its hash table and a key to resolve the iterator again
+template <class ElemType>
+class OutOfCoreHashTableIterator : public std::iterator<std::input_iterator_tag, std::pair<KeyType, ElemType>> {
+
+public:
+
+    // prefix
+    // the next partition is loaded when the current one is passed
+    OutOfCoreHashTableIterator& operator++() {
+        table->resolve(*this);
+        ++(*partitionIterator);
+        if (*partitionIterator == table->partitions[partition].table->end()) {
+            partition++;
+            table->moveIteratorToExistingValueOrEnd(*this);
+        }
+        else
+            key = (*partitionIterator)->first;
+        return *this;
+    }
+
+    // postfix
+    OutOfCoreHashTableIterator operator++(int) {
+        OutOfCoreHashTableIterator copy(*this);
+        ++(*this);
+        return copy;
+    }
+
+    std::pair<KeyType, ElemType>& operator*() const {
+        table->resolve(*this);
+        return **partitionIterator;
+    }
+
+    std::pair<KeyType, ElemType>* operator->() const {
+        return &(**this);
+    }
+
+    // keys are unique, so iterators are equal if they point to the same key
+    friend bool operator==(const OutOfCoreHashTableIterator& it1, const OutOfCoreHashTableIterator& it2) {
+        return it1.table == it2.table && it1.isEnd() == it2.isEnd() && (it1.isEnd() || it1.key == it2.key);
+    }
+
+    friend bool operator!=(const OutOfCoreHashTableIterator& it1, const OutOfCoreHashTableIterator& it2) {
+        return !(it1 == it2);
+    }
+
+private:
+
+    friend class OutOfCoreHashTable<ElemType>;
+
+    using TableType = OutOfCoreHashTable<ElemType>;
+    using HashTableIteratorType = typename HashTableOpenAddressing<ElemType>::iterator;
+
+    // iterator of inserted element, it is resolved on the first access
+    OutOfCoreHashTableIterator(TableType* table, size_t partition, KeyType key) :
+        table(table), partition(partition), key(key) {}
+
+    OutOfCoreHashTableIterator(TableType* table, size_t partition, const HashTableIteratorType& partitionIterator) :
+        table(table), partition(partition), partitionIterator(partitionIterator),
+        key(partitionIterator->first), version(table->layoutVersion) {}
+
+    bool isEnd() const {
+        return partition == TableType::END_PARTITION;
+    }
+
+    TableType* table;
+    // they are changed by resolving
+    mutable size_t partition;
+    mutable std::optional<HashTableIteratorType> partitionIterator;
+    KeyType key;
+    mutable uint64_t version = 0;
+
+};
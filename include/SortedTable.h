@@ -1,50 +1,494 @@
 #pragma once
 #include "Table.h"
+#include "BloomFilter.h"
 #include <functional>
 #include <algorithm>
+#include <cmath>
+#if defined(_MSC_VER) && (defined(_M_X64) || defined(_M_IX86))
+#include <xmmintrin.h>
+#endif
+
+
+template <class ElemType, class Allocator>
+class SortedTableIterator;
+
+// strategies of search in sorted table
+// BINARY - std::lower_bound
+// BRANCHLESS_BINARY - binary search without branches, it is faster for tables placed in cache
+// INTERPOLATION - interpolation search, it is faster for uniformly distributed keys
+// INTERPOLATION_SEQUENTIAL - interpolation search which looks through small range sequentially,
+//     it is faster for keys which are almost evenly spaced
+// AUTO - one of the previous strategies is chosen by sampled keys
+enum class SortedTableSearchStrategy {
+    BINARY,
+    BRANCHLESS_BINARY,
+    INTERPOLATION,
+    INTERPOLATION_SEQUENTIAL,
+    AUTO
+};
+
+// hint to load cache line of address, it doesn't wait for the memory
+inline void prefetchForRead(const void* address) {
+#if defined(__GNUC__) || defined(__clang__)
+    __builtin_prefetch(address, 0, 3);
+#elif defined(_MSC_VER) && (defined(_M_X64) || defined(_M_IX86))
+    _mm_prefetch(static_cast<const char*>(address), _MM_HINT_T0);
+#else
+    (void)address;
+#endif
+}
 
 // class of a sorted table
-// iterator for such table is just std::vector::iterator
-template <class ElemType>
+// it needs of its own iterator class SortedTableIterator
+// iterator skips elements which were erased lazily
+template <class ElemType, class Allocator = std::allocator<std::pair<KeyType, ElemType>>>
 class SortedTable : public TableByArray<ElemType,
-    typename std::vector<std::pair<KeyType, ElemType>>::iterator,
-    SortedTable<ElemType>> {
+    SortedTableIterator<ElemType, Allocator>,
+    SortedTable<ElemType, Allocator>, std::pair<KeyType, ElemType>, Allocator> {
 
 public:
 
-    // binary search O(log(n))
+    // search O(log(n)) or O(log(log(n))) depending on search strategy
+    // if the filter is enabled then most searches of missing keys are O(1)
     iterator find(const KeyType& key) {
-        std::pair<KeyType, ElemType> tmp(key, ElemType());
-        iterator searchRes = std::lower_bound(storage.begin(), storage.end(), tmp,
-            [](const std::pair<KeyType, ElemType>& a, const std::pair<KeyType, ElemType>& b) {
-            return a.first < b.first;
+        if (!filter.mayContain(key))
+            return end();
+        size_t cell = searchCell(key);
+        if (cell == storage.size() || storage[cell].first != key || isCellErased(cell)) {
+            filter.addFalsePositive();
+            return end();
+        }
+        return iterator(storage, isErased, cell);
+    }
+
+    // searches of keys [first, last), iterator of each key (or end()) is written to out in order of keys
+    // keys are searched in groups of FIND_BATCH_SIZE by interleaved branchless binary searches:
+    // every step of a search prefetches its next middle element and passes to the next search of the group,
+    // so cache misses of different searches overlap instead of waiting one by one
+    // it is faster than find for large tables, search strategy is not used, the filter is checked as in find
+    template <class KeyIterator, class OutputIterator>
+    void findBatch(KeyIterator first, KeyIterator last, OutputIterator out) {
+        KeyType keys[FIND_BATCH_SIZE];
+        size_t cells[FIND_BATCH_SIZE];
+        while (first != last) {
+            size_t count = 0;
+            for (; first != last && count < FIND_BATCH_SIZE; ++first)
+                keys[count++] = *first;
+            searchCellsInterleaved(keys, cells, count);
+            for (size_t i = 0; i < count; i++)
+                *out++ = iterator(storage, isErased, cells[i]);
+        }
+    }
+
+    // iterator to the first element with key not less than given, O(log(n))
+    iterator lowerBound(const KeyType& key) {
+        return iterator(storage, isErased, binarySearch(key));
+    }
+
+    // the same but the search starts from position from and the step is doubled (galloping)
+    // so it is O(log(d)) where d is the distance between from and the result
+    // it is fast if keys are searched in ascending order, e.g. when tables are merged
+    iterator lowerBound(const KeyType& key, const iterator& from) {
+        // keys before left are less than key, key at right is not less than key
+        size_t left = from.getCell(), right = left, step = 1;
+        while (right < storage.size() && storage[right].first < key) {
+            left = right + 1;
+            right += step;
+            step *= 2;
+        }
+        auto searchRes = std::lower_bound(storage.begin() + left, storage.begin() + std::min(right, storage.size()),
+            key, [](const std::pair<KeyType, ElemType>& a, const KeyType& b) {
+            return a.first < b;
         });
-        if (searchRes == storage.end() || searchRes->first != key)
-            return storage.end();
-        return searchRes;
+        return iterator(storage, isErased, searchRes - storage.begin());
     }
 
     // insertion O(n)
+    // if lazy erasing is enabled and key was erased lazily then its cell is reused, O(1)
     iterator insertWithoutSearch(const KeyType& key, ElemType&& elem) {
-        auto it = storage.begin();
-        for (; it != storage.end() && it->first < key; ++it);
-        auto insertedIter = storage.insert(it,
-            std::make_pair(key, std::move(elem)));  // here we are moving key and elem
-        return insertedIter;
+        if (filter.isFull())
+            rebuildFilter();
+        filter.add(key);
+        size_t cell = binarySearch(key);
+        auto it = storage.begin() + cell;
+        if (it != storage.end() && it->first == key && isCellErased(cell)) {
+            it->second = std::move(elem);
+            isErased[cell] = false;
+            erasedCount--;
+            return iterator(storage, isErased, cell);
+        }
+        storage.insert(it, std::make_pair(key, std::move(elem)));  // here we are moving key and elem
+        if (lazyErasing)
+            isErased.insert(isErased.begin() + cell, false);
+        return iterator(storage, isErased, cell);
     }
 
     // erasing O(n)
+    // if lazy erasing is enabled then element is just labeled as erased, O(1) amortized
+    // table is compacted when erased elements are more than MAX_ERASED_FRACTION of all cells
     void eraseWithoutSearch(const iterator& pos) {
-        storage.erase(pos);
+        if (!lazyErasing)
+            storage.erase(storage.begin() + pos.getCell());
+        else {
+            storage[pos.getCell()].second = ElemType();  // free resources of erased element
+            isErased[pos.getCell()] = true;
+            erasedCount++;
+            if (erasedCount > size_t(MAX_ERASED_FRACTION * storage.size()))
+                compact();
+        }
+        if (filter.addErasures(1))
+            rebuildFilter();
+    }
+
+    // erases all elements satisfying pred(const std::pair<KeyType, ElemType>&) in one pass O(n)
+    // elements are visited in ascending order of keys
+    // returns number of erased elements
+    template <class Predicate>
+    size_t eraseIf(Predicate pred) {
+        size_t oldSize = getSize();
+        size_t last = 0;
+        for (size_t i = 0; i < storage.size(); i++) {
+            if (isCellErased(i) || pred(storage[i]))
+                continue;
+            if (last != i)
+                storage[last] = std::move(storage[i]);
+            last++;
+        }
+        storage.erase(storage.begin() + last, storage.end());
+        if (lazyErasing)
+            isErased.assign(last, false);
+        erasedCount = 0;
+        if (filter.addErasures(oldSize - last))
+            rebuildFilter();
+        return oldSize - last;
+    }
+
+    // erases all elements with keys from sorted range [first, last) in one pass O(n + k)
+    // returns number of erased elements
+    template <class KeyIterator>
+    size_t eraseKeys(KeyIterator first, KeyIterator last) {
+        // both sequences are sorted so they are merged
+        return eraseIf([&first, &last](const std::pair<KeyType, ElemType>& elem) {
+            for (; first != last && *first < elem.first; ++first);
+            return first != last && *first == elem.first;
+        });
+    }
+
+    // removes cells of lazily erased elements, O(n)
+    void compact() {
+        eraseIf([](const std::pair<KeyType, ElemType>&) { return false; });
+    }
+
+    // if lazy erasing is enabled then erasing just labels element as erased
+    // it is useful if a lot of elements are erased one by one
+    void setLazyErasing(bool enabled) {
+        if (!enabled) {
+            compact();
+            std::vector<bool> tmp;
+            std::swap(tmp, isErased);
+        }
+        else if (!lazyErasing) {
+            isErased.assign(storage.size(), false);
+        }
+        lazyErasing = enabled;
+    }
+
+    bool isLazyErasing() const {
+        return lazyErasing;
+    }
+
+    // AUTO strategy samples keys and chooses one of the other strategies
+    // keys are sampled again if size of table is changed twice
+    void setSearchStrategy(SortedTableSearchStrategy strategy) {
+        searchStrategy = strategy;
+        currentSearchStrategy = strategy;
+        if (strategy == SortedTableSearchStrategy::AUTO)
+            chooseSearchStrategy();
+    }
+
+    SortedTableSearchStrategy getSearchStrategy() const {
+        return searchStrategy;
+    }
+
+    // strategy which is really used, it differs from getSearchStrategy() only for AUTO
+    SortedTableSearchStrategy getCurrentSearchStrategy() const {
+        return currentSearchStrategy;
+    }
+
+    // bloom filter which is checked by find before search, O(n) to enable
+    // it is useful if most of searched keys are missing in table
+    void setFilterEnabled(bool enabled) {
+        if (enabled)
+            rebuildFilter();
+        else
+            filter.disable();
+    }
+
+    bool isFilterEnabled() const {
+        return filter.isEnabled();
+    }
+
+    // statistics of the filter: size, false positive rate
+    const TableFilter& getFilter() const {
+        return filter;
+    }
+
+    void clear() {
+        TableByArrayType::clear();
+        isErased.clear();
+        erasedCount = 0;
+        filter.clear();
+    }
+
+    size_t getSize() const {
+        return storage.size() - erasedCount;
+    }
+
+    bool isEmpty() const {
+        return getSize() == 0;
     }
 
 
     iterator begin() {
-        return storage.begin();
+        return iterator(storage, isErased, 0);
     }
 
     iterator end() {
-        return storage.end();
+        return iterator(storage, isErased, storage.size());
+    }
+
+protected:
+
+    // labels of lazily erased elements, the same size as storage if lazy erasing is enabled
+    std::vector<bool> isErased;
+    size_t erasedCount = 0;
+    bool lazyErasing = false;
+
+    static constexpr double MAX_ERASED_FRACTION = 0.25;  // if erasedCount > MAX_ERASED_FRACTION*storage.size()
+                                                         // then compact
+
+    bool isCellErased(size_t cell) const {
+        return lazyErasing && isErased[cell];
+    }
+
+    TableFilter filter;
+    static constexpr size_t MIN_FILTER_CAPACITY = 1024;
+
+    // the filter has capacity of twice as many keys as in table
+    void rebuildFilter() {
+        filter.rebuild(begin(), end(), std::max(MIN_FILTER_CAPACITY, 2 * getSize()));
+    }
+
+    SortedTableSearchStrategy searchStrategy = SortedTableSearchStrategy::BINARY;
+    SortedTableSearchStrategy currentSearchStrategy = SortedTableSearchStrategy::BINARY;
+    size_t sampledSize = 0;  // size of table when keys were sampled by AUTO strategy
+
+    static const size_t SEQUENTIAL_SEARCH_THRESHOLD = 16;  // interpolation-sequential search looks through
+                                                           // so many cells sequentially
+    static const size_t SAMPLE_SIZE = 64;                  // number of keys sampled by AUTO strategy
+    static const size_t MAX_INTERPOLATION_ERROR_DIV = 64;  // interpolation is used if average error of
+                                                           // interpolation is less than size/MAX_INTERPOLATION_ERROR_DIV
+
+    // returns cell of key or any other cell if key is not in table
+    size_t searchCell(const KeyType& key) {
+        if (searchStrategy == SortedTableSearchStrategy::AUTO &&
+            (storage.size() > 2 * sampledSize || 2 * storage.size() < sampledSize))
+            chooseSearchStrategy();
+        switch (currentSearchStrategy) {
+        case SortedTableSearchStrategy::BRANCHLESS_BINARY:
+            return branchlessBinarySearch(key);
+        case SortedTableSearchStrategy::INTERPOLATION:
+            return interpolationSearch(key, 0);
+        case SortedTableSearchStrategy::INTERPOLATION_SEQUENTIAL:
+            return interpolationSearch(key, SEQUENTIAL_SEARCH_THRESHOLD);
+        default:
+            return binarySearch(key);
+        }
+    }
+
+    // binary search O(log(n)), returns the first cell with key not less than given
+    size_t binarySearch(const KeyType& key) const {
+        auto searchRes = std::lower_bound(storage.begin(), storage.end(), key,
+            [](const std::pair<KeyType, ElemType>& a, const KeyType& b) {
+            return a.first < b;
+        });
+        return searchRes - storage.begin();
+    }
+
+    // binary search O(log(n)) without unpredictable branches, the comparison is compiled to cmov
+    // returns the first cell with key not less than given
+    size_t branchlessBinarySearch(const KeyType& key) const {
+        if (storage.empty())
+            return 0;
+        const std::pair<KeyType, ElemType>* base = storage.data();
+        size_t n = storage.size();
+        while (n > 1) {
+            size_t half = n / 2;
+            base = (base[half].first < key) ? base + half : base;
+            n -= half;
+        }
+        return (base - storage.data()) + (base->first < key);
+    }
+
+    static const size_t FIND_BATCH_SIZE = 16;  // number of interleaved searches in findBatch
+
+    // branchless binary searches of count keys going in lockstep, all of them have the same number of steps
+    // cells[i] is the cell of keys[i] or storage.size() if key is missing
+    void searchCellsInterleaved(const KeyType* keys, size_t* cells, size_t count) {
+        // searches of keys rejected by the filter are not started
+        const std::pair<KeyType, ElemType>* bases[FIND_BATCH_SIZE];
+        size_t searches[FIND_BATCH_SIZE];
+        size_t searchesCount = 0;
+        for (size_t i = 0; i < count; i++) {
+            cells[i] = storage.size();
+            if (!storage.empty() && filter.mayContain(keys[i])) {
+                bases[searchesCount] = storage.data();
+                searches[searchesCount++] = i;
+            }
+        }
+        size_t n = storage.size();
+        while (n > 1) {
+            size_t half = n / 2;
+            size_t nextHalf = (n - half) / 2;
+            for (size_t j = 0; j < searchesCount; j++) {
+                const std::pair<KeyType, ElemType>* base = bases[j];
+                base = (base[half].first < keys[searches[j]]) ? base + half : base;
+                prefetchForRead(base + nextHalf);
+                bases[j] = base;
+            }
+            n -= half;
+        }
+        for (size_t j = 0; j < searchesCount; j++) {
+            KeyType key = keys[searches[j]];
+            size_t cell = (bases[j] - storage.data()) + (bases[j]->first < key);
+            if (cell == storage.size() || storage[cell].first != key || isCellErased(cell))
+                filter.addFalsePositive();
+            else
+                cells[searches[j]] = cell;
+        }
+    }
+
+    // interpolation search O(log(log(n))) on the average for uniformly distributed keys
+    // if interpolation step doesn't halve range of search then the next step is bisection
+    // so it is O(log(n)) in the worst case
+    // if range of search is not longer than sequentialThreshold it is looked through sequentially
+    size_t interpolationSearch(const KeyType& key, size_t sequentialThreshold) const {
+        if (storage.empty())
+            return 0;
+        // if key is in table then it is in [left, right]
+        size_t left = 0, right = storage.size() - 1;
+        bool isBisection = false;
+        while (right - left > sequentialThreshold) {
+            KeyType leftKey = storage[left].first, rightKey = storage[right].first;
+            if (key <= leftKey)
+                return left;
+            if (key > rightKey)
+                return right + 1;
+            // keys are unique so rightKey > leftKey
+            size_t length = right - left;
+            size_t mid = isBisection ? left + length / 2 :
+                left + size_t(uint64_t(key - leftKey) * length / (rightKey - leftKey));
+            if (storage[mid].first < key)
+                left = mid + 1;
+            else if (storage[mid].first > key)
+                right = mid - 1;
+            else
+                return mid;
+            isBisection = !isBisection && right - left > length / 2;
+        }
+        for (; left < right && storage[left].first < key; left++);
+        return left;
+    }
+
+    // compares positions of sampled keys with positions predicted by linear interpolation
+    void chooseSearchStrategy() {
+        sampledSize = storage.size();
+        if (storage.size() < SAMPLE_SIZE) {
+            currentSearchStrategy = SortedTableSearchStrategy::BRANCHLESS_BINARY;
+            return;
+        }
+        double firstKey = storage.front().first, lastKey = storage.back().first;
+        double error = 0;
+        for (size_t i = 0; i < SAMPLE_SIZE; i++) {
+            size_t cell = i * (storage.size() - 1) / (SAMPLE_SIZE - 1);
+            double predictedCell = (storage[cell].first - firstKey) / (lastKey - firstKey) * (storage.size() - 1);
+            error += std::abs(predictedCell - cell);
+        }
+        error /= SAMPLE_SIZE;
+        if (error <= SEQUENTIAL_SEARCH_THRESHOLD)
+            currentSearchStrategy = SortedTableSearchStrategy::INTERPOLATION_SEQUENTIAL;
+        else if (error <= storage.size() / MAX_INTERPOLATION_ERROR_DIV)
+            currentSearchStrategy = SortedTableSearchStrategy::INTERPOLATION;
+        else
+            currentSearchStrategy = SortedTableSearchStrategy::BRANCHLESS_BINARY;
+    }
+
+};
+
+
+// iterator for previous table
+template <class ElemType, class Allocator>
+class SortedTableIterator : public std::iterator<std::input_iterator_tag, std::pair<KeyType, ElemType>> {
+
+public:
+
+    // prefix
+    SortedTableIterator& operator++() {
+        cell++;
+        moveIteratorToExistingValueOrEnd();
+        return *this;
+    }
+
+    // postfix
+    SortedTableIterator operator++(int) {
+        SortedTableIterator copy(*this);
+        ++(*this);
+        return copy;
+    }
+
+    std::pair<KeyType, ElemType>& operator*() const {
+        return storage.get()[cell];
+    }
+
+    std::pair<KeyType, ElemType>* operator->() const {
+        return &(storage.get()[cell]);
+    }
+
+    friend bool operator==(const SortedTableIterator& it1, const SortedTableIterator& it2) {
+        return it1.cell == it2.cell && it1.storage.get().data() == it2.storage.get().data();
+    }
+
+    friend bool operator!=(const SortedTableIterator& it1, const SortedTableIterator& it2) {
+        return !(it1 == it2);
+    }
+
+private:
+
+    friend class SortedTable<ElemType, Allocator>;
+
+    using CellType = std::pair<KeyType, ElemType>;
+
+    SortedTableIterator(const std::reference_wrapper<TableStorage<CellType, Allocator>>& storage,
+        const std::reference_wrapper<std::vector<bool>>& isErased, size_t cell) :
+        storage(storage), isErased(isErased), cell(cell) {
+        moveIteratorToExistingValueOrEnd();
+    }
+
+    size_t getCell() const {
+        return cell;
+    }
+
+    // iterator knows about storage and labels of erased elements
+    // iterator = cell of table
+    std::reference_wrapper<TableStorage<CellType, Allocator>> storage;
+    std::reference_wrapper<std::vector<bool>> isErased;
+    size_t cell;
+
+    // labels are empty if lazy erasing is disabled
+    void moveIteratorToExistingValueOrEnd() {
+        while (cell < isErased.get().size() && isErased.get()[cell]) {
+            cell++;
+        }
     }
 
-};
\ No newline at end of file
+};
@@ -0,0 +1,286 @@
+#pragma once
+#include "Table.h"
+#include <array>
+#include <stdexcept>
+#include <type_traits>
+
+
+template <class ElemType, size_t Capacity, bool IsConst = false>
+class StaticHashTableIterator;
+
+// cell of StaticHashTable, flags are the same as HashTableOpenAddressingCellLabel
+template <class ElemType>
+struct StaticHashTableCell {
+    std::pair<KeyType, ElemType> elem{};
+    bool isFilled = false;
+    bool isDeleted = false;
+};
+
+// class of a hash table with open addressing and capacity known at compile time
+// cells are stored in the inline array, so the table doesn't allocate memory
+// the number of cells, the mask and the shift of hash function are compile time constants,
+// there is no repack, insertion to the full table throws std::length_error
+// all functions are constexpr, so a table of constants can be built at compile time:
+//     constexpr auto table = makeTable();  // makeTable is constexpr function inserting elements
+//     static_assert(table.find(5)->second == 25);
+// hash function is multiply-shift with the fixed odd parameter (there is no randomness at compile time)
+// probe sequence is triangular, it looks through all cells of table of size 2^M
+// erased elements are marked as deleted, their cells are reused by insertion
+// if more than 1/4 of cells are deleted then the table is rebuilt in place by erasure,
+// so unsuccessful searches stay short after many insertions and erasures
+template <class ElemType, size_t Capacity>
+class StaticHashTable : public Table<ElemType,
+    StaticHashTableIterator<ElemType, Capacity>,
+    StaticHashTable<ElemType, Capacity>> {
+
+    static_assert(Capacity > 0, "Capacity of StaticHashTable must be positive");
+
+public:
+
+    using iterator = StaticHashTableIterator<ElemType, Capacity>;
+    using const_iterator = StaticHashTableIterator<ElemType, Capacity, true>;
+
+    constexpr StaticHashTable() = default;
+
+    // search O(1) on the average
+    constexpr iterator find(const KeyType& key) {
+        return iterator(storage.data(), findCell(key));
+    }
+
+    constexpr const_iterator find(const KeyType& key) const {
+        return const_iterator(storage.data(), findCell(key));
+    }
+
+    // the same as Table::insert but constexpr
+    constexpr std::pair<iterator, bool> insert(const KeyType& key, const ElemType& elem) {
+        ElemType copy = elem;
+        return insert(key, std::move(copy));
+    }
+
+    constexpr std::pair<iterator, bool> insert(const KeyType& key, ElemType&& elem) {
+        iterator searchRes = find(key);
+        if (searchRes != end())
+            return std::make_pair(searchRes, false);
+        return std::make_pair(insertWithoutSearch(key, std::move(elem)), true);
+    }
+
+    constexpr iterator insertWithoutSearch(const KeyType& key, const ElemType& elem) {
+        ElemType copy = elem;
+        return insertWithoutSearch(key, std::move(copy));
+    }
+
+    // insertion O(1) on the average
+    // we consider that deleted elements are not in the table
+    constexpr iterator insertWithoutSearch(const KeyType& key, ElemType&& elem) {
+        if (size == Capacity)
+            throw std::length_error("StaticHashTable is full");
+        size_t cell = hash(key);
+        for (size_t i = 1; storage[cell].isFilled; i++)  // there is an empty cell because size < TABLE_SIZE
+            cell = (cell + i) & MASK;
+        storage[cell].elem.first = key;
+        storage[cell].elem.second = std::move(elem);
+        storage[cell].isFilled = true;
+        if (storage[cell].isDeleted) {
+            storage[cell].isDeleted = false;
+            deletedCount--;
+        }
+        size++;
+        return iterator(storage.data(), cell);
+    }
+
+    constexpr bool erase(const KeyType& key) {
+        iterator searchRes = find(key);
+        if (searchRes == end())
+            return false;
+        eraseWithoutSearch(searchRes);
+        return true;
+    }
+
+    // erasing O(1) on the average, rebuild takes O(TABLE_SIZE) after TABLE_SIZE / 4 erasures
+    // sets a label and frees resources of element
+    constexpr void eraseWithoutSearch(const iterator& pos) {
+        StaticHashTableCell<ElemType>& cell = storage[pos.cell];
+        cell.elem.second = ElemType();
+        cell.isFilled = false;
+        cell.isDeleted = true;
+        size--;
+        if (++deletedCount > MAX_DELETED_COUNT)
+            rebuild();
+    }
+
+    constexpr void clear() {
+        for (auto& cell : storage) {
+            cell.elem.first = KeyType();
+            cell.elem.second = ElemType();
+            cell.isFilled = false;
+            cell.isDeleted = false;
+        }
+        size = 0;
+        deletedCount = 0;
+    }
+
+    constexpr size_t getSize() const {
+        return size;
+    }
+
+    constexpr bool isEmpty() const {
+        return size == 0;
+    }
+
+    static constexpr size_t getCapacity() {
+        return Capacity;
+    }
+
+
+    constexpr iterator begin() {
+        return iterator(storage.data(), 0);
+    }
+
+    constexpr iterator end() {
+        return iterator(storage.data(), TABLE_SIZE);
+    }
+
+    constexpr const_iterator begin() const {
+        return const_iterator(storage.data(), 0);
+    }
+
+    constexpr const_iterator end() const {
+        return const_iterator(storage.data(), TABLE_SIZE);
+    }
+
+protected:
+
+    friend class StaticHashTableIterator<ElemType, Capacity>;
+    friend class StaticHashTableIterator<ElemType, Capacity, true>;
+
+    // the least M such that Capacity <= MAX_FILL_FACTOR * 2^M, MAX_FILL_FACTOR = 0.7
+    static constexpr uint32_t getTableSizeDeg() {
+        uint32_t M = 1;
+        while ((size_t(1) << M) * 7 < Capacity * 10)
+            M++;
+        return M;
+    }
+
+    static constexpr uint32_t M = getTableSizeDeg();
+    static constexpr size_t TABLE_SIZE = size_t(1) << M;
+    static constexpr size_t MASK = TABLE_SIZE - 1;
+    static constexpr uint32_t SHIFT = 64 - M;
+    static constexpr uint64_t A = 0x9E3779B97F4A7C15;  // 2^64 / golden ratio, it is odd
+    static constexpr size_t MAX_DELETED_COUNT = TABLE_SIZE / 4;
+
+    std::array<StaticHashTableCell<ElemType>, TABLE_SIZE> storage{};
+    size_t size = 0;
+    size_t deletedCount = 0;
+
+    static constexpr size_t hash(KeyType key) {
+        return size_t((A * uint64_t(key)) >> SHIFT);
+    }
+
+    // returns the cell with key or TABLE_SIZE
+    constexpr size_t findCell(KeyType key) const {
+        size_t cell = hash(key);
+        for (size_t i = 1; i <= TABLE_SIZE; i++) {
+            if (storage[cell].isFilled && storage[cell].elem.first == key)
+                return cell;
+            if (!storage[cell].isFilled && !storage[cell].isDeleted)  // cell is free and element was not deleted
+                return TABLE_SIZE;
+            cell = (cell + i) & MASK;
+        }
+        return TABLE_SIZE;
+    }
+
+    // removes labels of deleted elements and moves every element to the first free cell of its probe sequence
+    // it is done in place, O(TABLE_SIZE) on the average
+    // elements which are not placed yet are marked as filled and deleted,
+    // an element is swapped with such an element if it takes its cell
+    constexpr void rebuild() {
+        for (auto& cell : storage)
+            cell.isDeleted = cell.isFilled;
+        for (size_t start = 0; start < TABLE_SIZE; start++) {
+            if (!storage[start].isDeleted)
+                continue;
+            KeyType key = storage[start].elem.first;
+            ElemType elem = std::move(storage[start].elem.second);
+            storage[start].elem.second = ElemType();
+            storage[start].isFilled = false;
+            storage[start].isDeleted = false;
+            bool isPlaced = false;
+            while (!isPlaced) {
+                size_t cell = hash(key);
+                for (size_t i = 1; storage[cell].isFilled && !storage[cell].isDeleted; i++)  // placed element
+                    cell = (cell + i) & MASK;
+                KeyType nextKey = storage[cell].elem.first;
+                ElemType nextElem = std::move(storage[cell].elem.second);
+                isPlaced = !storage[cell].isFilled;  // otherwise the element which is not placed yet is moved
+                storage[cell].elem.first = key;
+                storage[cell].elem.second = std::move(elem);
+                storage[cell].isFilled = true;
+                storage[cell].isDeleted = false;
+                key = nextKey;
+                elem = std::move(nextElem);
+            }
+        }
+        deletedCount = 0;
+    }
+
+};
+
+
+// iterator for previous table
+// iterator = cell of table
+// IsConst is true for const_iterator of const table
+template <class ElemType, size_t Capacity, bool IsConst>
+class StaticHashTableIterator : public std::iterator<std::input_iterator_tag, std::pair<KeyType, ElemType>> {
+
+    using CellType = std::conditional_t<IsConst, const StaticHashTableCell<ElemType>, StaticHashTableCell<ElemType>>;
+    using ReferenceType = std::conditional_t<IsConst, const std::pair<KeyType, ElemType>&, std::pair<KeyType, ElemType>&>;
+
+public:
+
+    // prefix
+    constexpr StaticHashTableIterator& operator++() {
+        cell++;
+        moveIteratorToExistingValueOrEnd();
+        return *this;
+    }
+
+    // postfix
+    constexpr StaticHashTableIterator operator++(int) {
+        StaticHashTableIterator copy(*this);
+        ++(*this);
+        return copy;
+    }
+
+    constexpr ReferenceType operator*() const {
+        return cells[cell].elem;
+    }
+
+    constexpr auto operator->() const {
+        return &cells[cell].elem;
+    }
+
+    friend constexpr bool operator==(const StaticHashTableIterator& it1, const StaticHashTableIterator& it2) {
+        return it1.cell == it2.cell && it1.cells == it2.cells;
+    }
+
+    friend constexpr bool operator!=(const StaticHashTableIterator& it1, const StaticHashTableIterator& it2) {
+        return !(it1 == it2);
+    }
+
+private:
+
+    friend class StaticHashTable<ElemType, Capacity>;
+
+    constexpr StaticHashTableIterator(CellType* cells, size_t cell) : cells(cells), cell(cell) {
+        moveIteratorToExistingValueOrEnd();
+    }
+
+    CellType* cells;
+    size_t cell;
+
+    constexpr void moveIteratorToExistingValueOrEnd() {
+        while (cell < StaticHashTable<ElemType, Capacity>::TABLE_SIZE && !cells[cell].isFilled)
+            cell++;
+    }
+
+};
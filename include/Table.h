@@ -4,10 +4,17 @@
 #include <iostream>
 #include <type_traits>
 #include <cstdint>
+#include <memory>
 
 // key is a type of uint32_t
 typedef uint32_t KeyType;
 
+// array of cells of table
+// Allocator is rebound to CellType, so tables can take allocator of any type
+template <class CellType, class Allocator>
+using TableStorage = std::vector<CellType,
+    typename std::allocator_traits<Allocator>::template rebind_alloc<CellType>>;
+
 
 // a base class for tables
 // ElemType is a type of elements
@@ -23,7 +30,7 @@ public:
     // so we will can to write "typename AnyTable<TypeElem>::iterator it = table.begin()"
     using iterator = IteratorType;
 
-    Table() {
+    constexpr Table() {
         // static_assert is executed by the compilation stage
         // it just checks if DerivedType is derived by Table
         static_assert(std::is_base_of<Table, DerivedType>::value, "Derived class is not of Table type");
@@ -120,8 +127,9 @@ protected:
 // CellType is a type of one cell of table
 // by default it is std::pair<key, value> (for UnsortedTable and SortedTable)
 // or it is std::list<std::pair<key, value>> or std::pair<std::pair<key, value>, label> for hash tables 
+// Allocator is used to allocate storage, e.g. HugePageAllocator for very large tables
 template <class ElemType, class IteratorType, class DerivedType,
-    class CellType = std::pair<KeyType, ElemType>>
+    class CellType = std::pair<KeyType, ElemType>, class Allocator = std::allocator<CellType>>
 class TableByArray : public Table<ElemType, IteratorType, DerivedType> {
 
 public:
@@ -129,7 +137,7 @@ public:
     TableByArray(size_t size = 0) : storage(size) {}
 
     void clear() {
-        std::vector<CellType> tmp;
+        TableStorage<CellType, Allocator> tmp;
         std::swap(tmp, storage);
     }
 
@@ -144,8 +152,8 @@ public:
     
 protected:
 
-    using TableByArrayType = TableByArray<ElemType, IteratorType, DerivedType, CellType>;
+    using TableByArrayType = TableByArray<ElemType, IteratorType, DerivedType, CellType, Allocator>;
 
-    std::vector<CellType> storage;
+    TableStorage<CellType, Allocator> storage;
 
 };
\ No newline at end of file
@@ -0,0 +1,359 @@
+#pragma once
+#include "SortedTable.h"
+#include "HashTable.h"
+#include <thread>
+#include <type_traits>
+#include <vector>
+
+
+// set operations and join of two tables of the same kind
+// intersect(a, b) - elements of a with keys which are in b
+// unite(a, b) - elements of a and elements of b with keys which are not in a
+// difference(a, b) - elements of a with keys which are not in b
+// join(a, b, callback) - callback(key, elemA, elemB) is called for every key which is in both tables
+// sorted tables are merged, elements of the larger table are found by galloping search if sizes differ a lot
+// hash tables are split into partitions by the highest bits of hash values (radix partitioning),
+// partitions are small enough to be in cache, so elements are matched without cache misses
+// partitions can be processed by several threads, in this case callback of join is called concurrently
+
+template <class TableType>
+struct IsHashTable : std::false_type {};
+
+template <class ElemType, class Allocator>
+struct IsHashTable<HashTableOpenAddressing<ElemType, Allocator>> : std::true_type {};
+
+template <class ElemType, class Allocator>
+struct IsHashTable<HashTableSeparateChaining<ElemType, Allocator>> : std::true_type {};
+
+template <class TableType>
+struct IsSortedTable : std::false_type {};
+
+template <class ElemType, class Allocator>
+struct IsSortedTable<SortedTable<ElemType, Allocator>> : std::true_type {};
+
+// type of elements of table
+template <class TableType>
+using TableElemType = typename std::remove_reference<decltype(std::declval<TableType&>().begin()->second)>::type;
+
+
+// matches elements of two hash tables partition by partition
+// both tables are partitioned by hash function of build table
+// small hash index is built for every partition of build table, then partition of probe table is looked through
+template <class ProbeTableType, class BuildTableType>
+class HashTablePartitionedMatcher {
+
+public:
+
+    using ProbeElemType = TableElemType<ProbeTableType>;
+    using BuildElemType = TableElemType<BuildTableType>;
+
+    static const size_t MAX_PARTITION_SIZE = size_t(1) << 18;  // bytes of both sides of partition,
+                                                               // they should fit in L2 cache
+    static const uint32_t MAX_PARTITION_BITS = 16;
+    static const size_t PARTITIONS_PER_THREAD = 4;            // so threads are loaded evenly
+
+    HashTablePartitionedMatcher(ProbeTableType& probeTable, BuildTableType& buildTable, size_t threadsCount) :
+        buildTable(buildTable), threadsCount(std::max(threadsCount, size_t(1))) {
+        size_t bytes = probeTable.getSize() * sizeof(PartitionedElem<ProbeElemType>) +
+            buildTable.getSize() * sizeof(PartitionedElem<BuildElemType>);
+        for (; bitsCount < MAX_PARTITION_BITS && (bytes >> bitsCount) > MAX_PARTITION_SIZE; bitsCount++);
+        if (this->threadsCount > 1)
+            for (; bitsCount < MAX_PARTITION_BITS &&
+                (size_t(1) << bitsCount) < this->threadsCount * PARTITIONS_PER_THREAD; bitsCount++);
+        partition(probeTable, probeElems, probeOffsets);
+        partition(buildTable, buildElems, buildOffsets);
+    }
+
+    // callback(thread, key, probeElem, buildElem) is called for every element of probe table
+    // buildElem is a pointer to element of build table with the same key or nullptr
+    // thread is a number from 0 to getThreadsCount() - 1, calls from different threads are concurrent
+    template <class Callback>
+    void run(Callback callback) {
+        size_t partitionsCount = size_t(1) << bitsCount;
+        if (threadsCount == 1) {
+            matchPartitions(0, partitionsCount, 0, callback);
+            return;
+        }
+        std::vector<std::thread> threads;
+        for (size_t thread = 0; thread < threadsCount; thread++)
+            threads.emplace_back([this, thread, partitionsCount, &callback]() {
+                matchPartitions(thread * partitionsCount / threadsCount,
+                    (thread + 1) * partitionsCount / threadsCount, thread, callback);
+            });
+        for (auto& thread : threads)
+            thread.join();
+    }
+
+    size_t getThreadsCount() const {
+        return threadsCount;
+    }
+
+    size_t getPartitionsCount() const {
+        return size_t(1) << bitsCount;
+    }
+
+private:
+
+    template <class ElemType>
+    struct PartitionedElem {
+        KeyType key;
+        ElemType* elem;
+    };
+
+    BuildTableType& buildTable;
+    size_t threadsCount;
+    uint32_t bitsCount = 0;  // number of partitions = 2^bitsCount
+
+    // elements of partition i are in [offsets[i], offsets[i + 1])
+    std::vector<PartitionedElem<ProbeElemType>> probeElems;
+    std::vector<size_t> probeOffsets;
+    std::vector<PartitionedElem<BuildElemType>> buildElems;
+    std::vector<size_t> buildOffsets;
+
+    // parameter of hash function of index of partition
+    // it differs from parameter of build table, so keys of one partition are distributed evenly
+    static const uint64_t INDEX_HASH_PARAMETER = 0x9E3779B97F4A7C15;
+
+    uint32_t getPartition(KeyType key) const {
+        return buildTable.getHashPrefix(key, bitsCount);
+    }
+
+    static size_t getIndexCell(KeyType key, uint32_t indexBitsCount) {
+        return size_t((INDEX_HASH_PARAMETER * uint64_t(key)) >> (64 - indexBitsCount));
+    }
+
+    // table is looked through once, then elements are scattered to partitions
+    // elements of build table are often ordered by partitions already because cells are ordered by hash,
+    // then they are not scattered
+    template <class TableType, class ElemType>
+    void partition(TableType& table, std::vector<PartitionedElem<ElemType>>& elems, std::vector<size_t>& offsets) {
+        std::vector<PartitionedElem<ElemType>> tableElems;
+        tableElems.reserve(table.getSize());
+        offsets.assign(getPartitionsCount() + 1, 0);
+        bool isOrdered = true;
+        uint32_t lastPartition = 0;
+        for (auto it = table.begin(); it != table.end(); ++it) {
+            uint32_t partition = getPartition(it->first);
+            isOrdered = isOrdered && lastPartition <= partition;
+            lastPartition = partition;
+            tableElems.push_back(PartitionedElem<ElemType>{ it->first, &it->second });
+            offsets[partition + 1]++;
+        }
+        for (size_t i = 1; i < offsets.size(); i++)
+            offsets[i] += offsets[i - 1];
+        if (isOrdered) {
+            std::swap(elems, tableElems);
+            return;
+        }
+        elems.resize(tableElems.size());
+        std::vector<size_t> positions(offsets.begin(), offsets.end() - 1);
+        for (const auto& elem : tableElems)
+            elems[positions[getPartition(elem.key)]++] = elem;
+    }
+
+    template <class Callback>
+    void matchPartitions(size_t firstPartition, size_t lastPartition, size_t thread, Callback& callback) {
+        // index with linear probing, cell contains number of element in partition + 1, 0 is empty cell
+        std::vector<uint32_t> index;
+        for (size_t p = firstPartition; p < lastPartition; p++) {
+            size_t buildFirst = buildOffsets[p], buildCount = buildOffsets[p + 1] - buildFirst;
+            uint32_t indexBitsCount = 1;
+            for (; (size_t(1) << indexBitsCount) < 2 * buildCount; indexBitsCount++);
+            index.assign(size_t(1) << indexBitsCount, 0);
+            size_t mask = index.size() - 1;
+            for (size_t i = 0; i < buildCount; i++) {
+                size_t cell = getIndexCell(buildElems[buildFirst + i].key, indexBitsCount);
+                for (; index[cell] != 0; cell = (cell + 1) & mask);
+                index[cell] = uint32_t(i + 1);
+            }
+            for (size_t i = probeOffsets[p]; i < probeOffsets[p + 1]; i++) {
+                KeyType key = probeElems[i].key;
+                BuildElemType* buildElem = nullptr;
+                for (size_t cell = getIndexCell(key, indexBitsCount); index[cell] != 0; cell = (cell + 1) & mask)
+                    if (buildElems[buildFirst + index[cell] - 1].key == key) {
+                        buildElem = buildElems[buildFirst + index[cell] - 1].elem;
+                        break;
+                    }
+                callback(thread, key, *probeElems[i].elem, buildElem);
+            }
+        }
+    }
+
+};
+
+
+// if larger table is GALLOPING_SIZE_RATIO times larger than smaller one
+// then its elements are found by galloping search instead of looking through all elements
+const size_t GALLOPING_SIZE_RATIO = 8;
+
+// merges two sorted tables
+// callback(probeElem, buildElem) is called for every element of probe table in ascending order of keys
+// buildElem is a pointer to element of build table with the same key or nullptr
+template <class ProbeTableType, class BuildTableType, class Callback>
+void mergeSortedTables(ProbeTableType& probeTable, BuildTableType& buildTable, Callback callback) {
+    bool isGalloping = buildTable.getSize() > GALLOPING_SIZE_RATIO * probeTable.getSize();
+    auto buildIt = buildTable.begin();
+    for (auto it = probeTable.begin(); it != probeTable.end(); ++it) {
+        if (isGalloping)
+            buildIt = buildTable.lowerBound(it->first, buildIt);
+        else
+            for (; buildIt != buildTable.end() && buildIt->first < it->first; ++buildIt);
+        bool isFound = buildIt != buildTable.end() && buildIt->first == it->first;
+        callback(*it, isFound ? &buildIt->second : nullptr);
+    }
+}
+
+// inserts copies of elements to table, keys must not be in table
+template <class TableType>
+void insertElements(TableType& table,
+    const std::vector<std::vector<std::pair<KeyType, TableElemType<TableType>*>>>& elems) {
+    for (const auto& threadElems : elems)
+        for (const auto& elem : threadElems) {
+            TableElemType<TableType> copy = *elem.second;
+            table.insertWithoutSearch(elem.first, std::move(copy));
+        }
+}
+
+
+// hash tables, O(n + m)
+
+template <class TableType>
+typename std::enable_if<IsHashTable<TableType>::value, TableType>::type
+intersect(TableType& a, TableType& b, size_t threadsCount = 1) {
+    using ElemType = TableElemType<TableType>;
+    HashTablePartitionedMatcher<TableType, TableType> matcher(a, b, threadsCount);
+    std::vector<std::vector<std::pair<KeyType, ElemType*>>> found(matcher.getThreadsCount());
+    matcher.run([&found](size_t thread, KeyType key, ElemType& elemA, ElemType* elemB) {
+        if (elemB != nullptr)
+            found[thread].emplace_back(key, &elemA);
+    });
+    TableType result;
+    insertElements(result, found);
+    return result;
+}
+
+template <class TableType>
+typename std::enable_if<IsHashTable<TableType>::value, TableType>::type
+unite(TableType& a, TableType& b, size_t threadsCount = 1) {
+    using ElemType = TableElemType<TableType>;
+    HashTablePartitionedMatcher<TableType, TableType> matcher(b, a, threadsCount);
+    std::vector<std::vector<std::pair<KeyType, ElemType*>>> notFound(matcher.getThreadsCount());
+    matcher.run([&notFound](size_t thread, KeyType key, ElemType& elemB, ElemType* elemA) {
+        if (elemA == nullptr)
+            notFound[thread].emplace_back(key, &elemB);
+    });
+    TableType result(a);
+    insertElements(result, notFound);
+    return result;
+}
+
+template <class TableType>
+typename std::enable_if<IsHashTable<TableType>::value, TableType>::type
+difference(TableType& a, TableType& b, size_t threadsCount = 1) {
+    using ElemType = TableElemType<TableType>;
+    HashTablePartitionedMatcher<TableType, TableType> matcher(a, b, threadsCount);
+    std::vector<std::vector<std::pair<KeyType, ElemType*>>> notFound(matcher.getThreadsCount());
+    matcher.run([&notFound](size_t thread, KeyType key, ElemType& elemA, ElemType* elemB) {
+        if (elemB == nullptr)
+            notFound[thread].emplace_back(key, &elemA);
+    });
+    TableType result;
+    insertElements(result, notFound);
+    return result;
+}
+
+// index is built for the smaller table
+template <class TableTypeA, class TableTypeB, class Callback>
+typename std::enable_if<IsHashTable<TableTypeA>::value && IsHashTable<TableTypeB>::value>::type
+join(TableTypeA& a, TableTypeB& b, Callback callback, size_t threadsCount = 1) {
+    using ElemTypeA = TableElemType<TableTypeA>;
+    using ElemTypeB = TableElemType<TableTypeB>;
+    if (a.getSize() < b.getSize()) {
+        HashTablePartitionedMatcher<TableTypeB, TableTypeA> matcher(b, a, threadsCount);
+        matcher.run([&callback](size_t, KeyType key, ElemTypeB& elemB, ElemTypeA* elemA) {
+            if (elemA != nullptr)
+                callback(key, *elemA, elemB);
+        });
+    }
+    else {
+        HashTablePartitionedMatcher<TableTypeA, TableTypeB> matcher(a, b, threadsCount);
+        matcher.run([&callback](size_t, KeyType key, ElemTypeA& elemA, ElemTypeB* elemB) {
+            if (elemB != nullptr)
+                callback(key, elemA, *elemB);
+        });
+    }
+}
+
+
+// sorted tables, O(n + m) or O(n*log(m/n)) if m is much larger than n
+
+// the smaller table is looked through
+template <class TableType>
+typename std::enable_if<IsSortedTable<TableType>::value, TableType>::type
+intersect(TableType& a, TableType& b) {
+    using ElemType = TableElemType<TableType>;
+    TableType result;
+    if (a.getSize() <= b.getSize())
+        mergeSortedTables(a, b, [&result](std::pair<KeyType, ElemType>& elemA, ElemType* elemB) {
+            if (elemB != nullptr)
+                result.insertWithoutSearch(elemA.first, ElemType(elemA.second));
+        });
+    else
+        mergeSortedTables(b, a, [&result](std::pair<KeyType, ElemType>& elemB, ElemType* elemA) {
+            if (elemA != nullptr)
+                result.insertWithoutSearch(elemB.first, ElemType(*elemA));
+        });
+    return result;
+}
+
+// elements are appended to the end of result, so it is O(n + m)
+template <class TableType>
+typename std::enable_if<IsSortedTable<TableType>::value, TableType>::type
+unite(TableType& a, TableType& b) {
+    using ElemType = TableElemType<TableType>;
+    TableType result;
+    auto itA = a.begin(), itB = b.begin();
+    while (itA != a.end() || itB != b.end()) {
+        if (itB == b.end() || (itA != a.end() && itA->first <= itB->first)) {
+            if (itB != b.end() && itA->first == itB->first)
+                ++itB;
+            result.insertWithoutSearch(itA->first, ElemType(itA->second));
+            ++itA;
+        }
+        else {
+            result.insertWithoutSearch(itB->first, ElemType(itB->second));
+            ++itB;
+        }
+    }
+    return result;
+}
+
+template <class TableType>
+typename std::enable_if<IsSortedTable<TableType>::value, TableType>::type
+difference(TableType& a, TableType& b) {
+    using ElemType = TableElemType<TableType>;
+    TableType result;
+    mergeSortedTables(a, b, [&result](std::pair<KeyType, ElemType>& elemA, ElemType* elemB) {
+        if (elemB == nullptr)
+            result.insertWithoutSearch(elemA.first, ElemType(elemA.second));
+    });
+    return result;
+}
+
+// the smaller table is looked through, callback is called in ascending order of keys
+template <class TableTypeA, class TableTypeB, class Callback>
+typename std::enable_if<IsSortedTable<TableTypeA>::value && IsSortedTable<TableTypeB>::value>::type
+join(TableTypeA& a, TableTypeB& b, Callback callback) {
+    using ElemTypeA = TableElemType<TableTypeA>;
+    using ElemTypeB = TableElemType<TableTypeB>;
+    if (a.getSize() <= b.getSize())
+        mergeSortedTables(a, b, [&callback](std::pair<KeyType, ElemTypeA>& elemA, ElemTypeB* elemB) {
+            if (elemB != nullptr)
+                callback(elemA.first, elemA.second, *elemB);
+        });
+    else
+        mergeSortedTables(b, a, [&callback](std::pair<KeyType, ElemTypeB>& elemB, ElemTypeA* elemA) {
+            if (elemA != nullptr)
+                callback(elemB.first, *elemA, elemB.second);
+        });
+}
@@ -0,0 +1,184 @@
+#pragma once
+#include "Table.h"
+#include <cstring>
+#include <istream>
+#include <ostream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+
+// traces of operations with tables
+// a trace is recorded by TraceRecordingTable on the real load and then is replayed against any table
+// (see benchmark/bench_TraceReplay.cpp), so tables can be compared on the same sequence of operations
+// binary format: header TRACE_MAGIC, then records of TRACE_RECORD_SIZE bytes
+// record = operation (1 byte), key (4 bytes), size of value in bytes (4 bytes), numbers are little-endian
+
+enum class TraceOperation : uint8_t {
+    INSERT,
+    FIND,
+    ERASE
+};
+
+struct TraceRecord {
+    TraceOperation operation;
+    KeyType key;
+    uint32_t valueSize;  // 0 for find and erase
+};
+
+const char TRACE_MAGIC[8] = { 'T', 'B', 'L', 'T', 'R', 'A', 'C', '1' };
+const size_t TRACE_RECORD_SIZE = 9;
+
+// size of value which is written to trace
+// for containers it is the size of data, otherwise it is sizeof
+template <class ElemType>
+uint32_t getTraceValueSize(const ElemType&) {
+    return uint32_t(sizeof(ElemType));
+}
+
+inline uint32_t getTraceValueSize(const std::string& elem) {
+    return uint32_t(elem.size());
+}
+
+template <class T, class Allocator>
+uint32_t getTraceValueSize(const std::vector<T, Allocator>& elem) {
+    return uint32_t(elem.size() * sizeof(T));
+}
+
+
+// writes records to stream, header is written by constructor
+class TraceWriter {
+
+public:
+
+    TraceWriter(std::ostream& ostr) : ostr(ostr) {
+        ostr.write(TRACE_MAGIC, sizeof(TRACE_MAGIC));
+    }
+
+    void write(const TraceRecord& record) {
+        char buf[TRACE_RECORD_SIZE];
+        buf[0] = char(record.operation);
+        putUint32(buf + 1, record.key);
+        putUint32(buf + 5, record.valueSize);
+        ostr.write(buf, TRACE_RECORD_SIZE);
+    }
+
+private:
+
+    std::ostream& ostr;
+
+    static void putUint32(char* buf, uint32_t value) {
+        for (size_t i = 0; i < 4; i++)
+            buf[i] = char((value >> (8 * i)) & 0xFF);
+    }
+
+};
+
+
+// reads records from stream, header is checked by constructor
+// throws std::runtime_error if stream doesn't contain a trace
+class TraceReader {
+
+public:
+
+    TraceReader(std::istream& istr) : istr(istr) {
+        char magic[sizeof(TRACE_MAGIC)];
+        if (!istr.read(magic, sizeof(magic)) || std::memcmp(magic, TRACE_MAGIC, sizeof(magic)) != 0)
+            throw std::runtime_error("stream doesn't contain a trace of table operations");
+    }
+
+    // returns false if there are no more records
+    bool read(TraceRecord& record) {
+        char buf[TRACE_RECORD_SIZE];
+        if (!istr.read(buf, TRACE_RECORD_SIZE))
+            return false;
+        if (uint8_t(buf[0]) > uint8_t(TraceOperation::ERASE))
+            throw std::runtime_error("unknown operation in trace");
+        record.operation = TraceOperation(buf[0]);
+        record.key = getUint32(buf + 1);
+        record.valueSize = getUint32(buf + 5);
+        return true;
+    }
+
+    // reads all remaining records
+    std::vector<TraceRecord> readAll() {
+        std::vector<TraceRecord> records;
+        TraceRecord record;
+        while (read(record))
+            records.push_back(record);
+        return records;
+    }
+
+private:
+
+    std::istream& istr;
+
+    static uint32_t getUint32(const char* buf) {
+        uint32_t value = 0;
+        for (size_t i = 0; i < 4; i++)
+            value |= uint32_t(uint8_t(buf[i])) << (8 * i);
+        return value;
+    }
+
+};
+
+
+// thin wrapper around any table which writes every find, insert and erase to trace
+// e.g. TraceRecordingTable<HashTableOpenAddressing<std::string>> table(realTable, file);
+// insert and erase are recorded once, searches made by them inside the table are not recorded
+template <class TableType>
+class TraceRecordingTable {
+
+public:
+
+    using iterator = typename TableType::iterator;
+
+    TraceRecordingTable(TableType& table, std::ostream& ostr) : table(table), writer(ostr) {}
+
+    iterator find(const KeyType& key) {
+        writer.write(TraceRecord{ TraceOperation::FIND, key, 0 });
+        return table.find(key);
+    }
+
+    // elem is passed to the table as it is, so both copying and moving insert can be called
+    template <class ElemType>
+    std::pair<iterator, bool> insert(const KeyType& key, ElemType&& elem) {
+        writer.write(TraceRecord{ TraceOperation::INSERT, key, getTraceValueSize(elem) });
+        return table.insert(key, std::forward<ElemType>(elem));
+    }
+
+    bool erase(const KeyType& key) {
+        writer.write(TraceRecord{ TraceOperation::ERASE, key, 0 });
+        return table.erase(key);
+    }
+
+    void clear() {
+        table.clear();
+    }
+
+    bool isEmpty() const {
+        return table.isEmpty();
+    }
+
+    size_t getSize() const {
+        return table.getSize();
+    }
+
+    iterator begin() {
+        return table.begin();
+    }
+
+    iterator end() {
+        return table.end();
+    }
+
+    TableType& getTable() {
+        return table;
+    }
+
+private:
+
+    TableType& table;
+    TraceWriter writer;
+
+};
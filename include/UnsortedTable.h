@@ -1,13 +1,14 @@
 #pragma once
 #include "Table.h"
 #include <functional>
+#include <algorithm>
 
 // class of a sorted table
 // iterator for such table is just std::vector::iterator
-template <class ElemType>
+template <class ElemType, class Allocator = std::allocator<std::pair<KeyType, ElemType>>>
 class UnsortedTable : public TableByArray<ElemType,
-    typename std::vector<std::pair<KeyType, ElemType>>::iterator,
-    UnsortedTable<ElemType>> {
+    typename TableStorage<std::pair<KeyType, ElemType>, Allocator>::iterator,
+    UnsortedTable<ElemType, Allocator>, std::pair<KeyType, ElemType>, Allocator> {
 
 public:
 
@@ -30,6 +31,24 @@ public:
         storage.pop_back();
     }
 
+    // erases all elements satisfying pred(const std::pair<KeyType, ElemType>&) in one pass O(n)
+    // returns number of erased elements
+    template <class Predicate>
+    size_t eraseIf(Predicate pred) {
+        size_t oldSize = storage.size();
+        storage.erase(std::remove_if(storage.begin(), storage.end(), pred), storage.end());
+        return oldSize - storage.size();
+    }
+
+    // erases all elements with keys from sorted range [first, last) in one pass O(n*log(k))
+    // returns number of erased elements
+    template <class KeyIterator>
+    size_t eraseKeys(KeyIterator first, KeyIterator last) {
+        return eraseIf([first, last](const std::pair<KeyType, ElemType>& elem) {
+            return std::binary_search(first, last, elem.first);
+        });
+    }
+
 
     iterator begin() {
         return storage.begin();
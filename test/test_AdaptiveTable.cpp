@@ -0,0 +1,92 @@
+#include "AdaptiveTable.h"
+#include <string>
+
+#include "gtest/gtest.h"
+
+// inline capacity is 4 so promotion happens after 4 insertions
+typedef AdaptiveTable<std::string, 4> SmallAdaptiveTable;
+
+TEST(TestAdaptiveTable, is_not_promoted_if_table_is_small) {
+    SmallAdaptiveTable table;
+    for (KeyType i = 0; i < 4; i++)
+        table.insert(i, "a");
+
+    ASSERT_FALSE(table.isPromoted());
+}
+
+TEST(TestAdaptiveTable, is_promoted_if_inline_array_is_overflowed) {
+    SmallAdaptiveTable table;
+    for (KeyType i = 0; i < 5; i++)
+        table.insert(i, "a");
+
+    ASSERT_TRUE(table.isPromoted());
+}
+
+TEST(TestAdaptiveTable, promotion_dont_break_table) {
+    SmallAdaptiveTable table;
+    for (KeyType i = 0; i < 10; i++)
+        table.insert(i, std::string(1, char('a' + i)));
+
+    for (KeyType i = 0; i < 10; i++)
+        ASSERT_EQ(std::string(1, char('a' + i)), table.find(i)->second);
+    ASSERT_EQ(10, table.getSize());
+}
+
+TEST(TestAdaptiveTable, is_demoted_if_table_becomes_small) {
+    SmallAdaptiveTable table;
+    for (KeyType i = 0; i < 5; i++)
+        table.insert(i, "a");
+
+    for (KeyType i = 0; i < 3; i++)
+        table.erase(i);
+
+    ASSERT_FALSE(table.isPromoted());
+}
+
+TEST(TestAdaptiveTable, demotion_dont_break_table) {
+    SmallAdaptiveTable table;
+    for (KeyType i = 0; i < 5; i++)
+        table.insert(i, std::string(1, char('a' + i)));
+
+    for (KeyType i = 0; i < 3; i++)
+        table.erase(i);
+
+    ASSERT_EQ(table.end(), table.find(0));
+    ASSERT_EQ("d", table.find(3)->second);
+    ASSERT_EQ("e", table.find(4)->second);
+    ASSERT_EQ(2, table.getSize());
+}
+
+TEST(TestAdaptiveTable, promoted_table_is_iterable) {
+    SmallAdaptiveTable table;
+    for (KeyType i = 0; i < 10; i++)
+        table.insert(i, "a");
+
+    int ch = 0;
+    for (auto it = table.begin(); it != table.end(); ++it, ++ch)
+        ASSERT_EQ(it->second, "a");
+    ASSERT_EQ(10, ch);
+}
+
+TEST(TestAdaptiveTable, can_clear_promoted_table) {
+    SmallAdaptiveTable table;
+    for (KeyType i = 0; i < 10; i++)
+        table.insert(i, "a");
+
+    table.clear();
+
+    ASSERT_TRUE(table.isEmpty());
+    ASSERT_FALSE(table.isPromoted());
+}
+
+TEST(TestAdaptiveTable, can_copy_promoted_table) {
+    SmallAdaptiveTable table;
+    for (KeyType i = 0; i < 10; i++)
+        table.insert(i, "a");
+
+    SmallAdaptiveTable copy(table);
+    table.erase(1);
+
+    ASSERT_EQ("a", copy.find(1)->second);
+    ASSERT_EQ(10, copy.getSize());
+}
@@ -0,0 +1,80 @@
+#include "BloomFilter.h"
+#include <utility>
+#include <vector>
+
+#include "gtest/gtest.h"
+
+TEST(TestBloomFilter, has_no_false_negatives) {
+    BloomFilter filter(1000);
+    for (KeyType i = 0; i < 1000; i++)
+        filter.add(i * 7919);
+
+    for (KeyType i = 0; i < 1000; i++)
+        ASSERT_TRUE(filter.mayContain(i * 7919));
+}
+
+TEST(TestBloomFilter, false_positive_rate_is_small) {
+    BloomFilter filter(10000);
+    for (KeyType i = 0; i < 10000; i++)
+        filter.add(i);
+
+    size_t falsePositivesCount = 0;
+    for (KeyType i = 10000; i < 110000; i++)
+        falsePositivesCount += filter.mayContain(i);
+
+    ASSERT_LT(falsePositivesCount, 2000);  // about 1%
+    ASSERT_LT(filter.getExpectedFalsePositiveRate(), 0.02);
+}
+
+TEST(TestBlockedBloomFilter, has_no_false_negatives) {
+    BlockedBloomFilter filter(1000);
+    for (KeyType i = 0; i < 1000; i++)
+        filter.add(i * 7919);
+
+    for (KeyType i = 0; i < 1000; i++)
+        ASSERT_TRUE(filter.mayContain(i * 7919));
+}
+
+TEST(TestBlockedBloomFilter, false_positive_rate_is_small) {
+    BlockedBloomFilter filter(10000);
+    for (KeyType i = 0; i < 10000; i++)
+        filter.add(i);
+
+    size_t falsePositivesCount = 0;
+    for (KeyType i = 10000; i < 110000; i++)
+        falsePositivesCount += filter.mayContain(i);
+
+    ASSERT_LT(falsePositivesCount, 2500);  // about 1.2%
+    ASSERT_EQ(0, filter.getMemorySize() % 64);
+}
+
+TEST(TestTableFilter, counts_rejects_and_false_positives) {
+    std::vector<std::pair<KeyType, int>> elems = { { 1, 0 }, { 2, 0 } };
+    TableFilter filter;
+    filter.rebuild(elems.begin(), elems.end(), 100);
+
+    for (KeyType i = 3; i < 1003; i++)
+        if (filter.mayContain(i))
+            filter.addFalsePositive();
+
+    ASSERT_TRUE(filter.mayContain(1));
+    ASSERT_EQ(1000, filter.getRejectsCount() + filter.getFalsePositivesCount());
+    ASSERT_LT(filter.getFalsePositiveRate(), 0.05);
+}
+
+TEST(TestTableFilter, asks_to_rebuild_if_a_half_of_keys_are_erased) {
+    std::vector<std::pair<KeyType, int>> elems = { { 1, 0 }, { 2, 0 }, { 3, 0 }, { 4, 0 } };
+    TableFilter filter;
+    filter.rebuild(elems.begin(), elems.end(), 100);
+
+    ASSERT_FALSE(filter.addErasures(2));
+    ASSERT_TRUE(filter.addErasures(1));
+}
+
+TEST(TestTableFilter, disabled_filter_passes_all_keys) {
+    TableFilter filter;
+
+    ASSERT_TRUE(filter.mayContain(5));
+    ASSERT_FALSE(filter.addErasures(100));
+    ASSERT_EQ(0, filter.getMemorySize());
+}
@@ -0,0 +1,101 @@
+#include "CompressedSortedTable.h"
+#include <string>
+#include <vector>
+
+#include "gtest/gtest.h"
+
+class TestCompressedSortedTable : public CompressedSortedTable<int>, public testing::Test {
+
+public:
+
+    CompressedSortedTable<int>* table = this;
+
+    // several blocks are filled
+    void insertKeys(KeyType count, KeyType step) {
+        for (KeyType i = 0; i < count; i++)
+            table->insert(i * step, int(i));
+    }
+
+};
+
+TEST_F(TestCompressedSortedTable, can_find_all_elements_in_several_blocks) {
+    insertKeys(1000, 3);
+
+    for (KeyType i = 0; i < 1000; i++)
+        ASSERT_EQ(int(i), table->find(i * 3)->second);
+    ASSERT_EQ(table->end(), table->find(1));
+    ASSERT_EQ(table->end(), table->find(3000));
+}
+
+TEST_F(TestCompressedSortedTable, can_insert_in_reversed_order) {
+    for (KeyType i = 1000; i > 0; i--)
+        table->insert(i, int(i));
+
+    for (KeyType i = 1; i <= 1000; i++)
+        ASSERT_EQ(int(i), table->find(i)->second);
+    ASSERT_EQ(1000, table->getSize());
+}
+
+TEST_F(TestCompressedSortedTable, block_is_split_if_it_is_overflowed) {
+    insertKeys(BLOCK_SIZE + 1, 1);
+
+    ASSERT_EQ(2, blocks.size());
+}
+
+TEST_F(TestCompressedSortedTable, iteration_gives_sorted_keys) {
+    for (KeyType i = 0; i < 500; i++)
+        table->insert((i * 7919) % 500, 0);
+
+    KeyType expected = 0;
+    for (auto it = table->begin(); it != table->end(); ++it, ++expected)
+        ASSERT_EQ(expected, it->first);
+    ASSERT_EQ(500, expected);
+}
+
+TEST_F(TestCompressedSortedTable, can_erase_elements_from_several_blocks) {
+    insertKeys(1000, 1);
+
+    for (KeyType i = 0; i < 1000; i += 2)
+        table->erase(i);
+
+    for (KeyType i = 0; i < 1000; i++)
+        ASSERT_EQ(i % 2 == 0, table->find(i) == table->end());
+    ASSERT_EQ(500, table->getSize());
+}
+
+TEST_F(TestCompressedSortedTable, empty_block_is_removed) {
+    insertKeys(BLOCK_SIZE + 1, 1);
+
+    for (KeyType i = 0; i < BLOCK_SIZE + 1; i++)
+        table->erase(i);
+
+    ASSERT_TRUE(table->isEmpty());
+    ASSERT_TRUE(blocks.empty());
+}
+
+TEST_F(TestCompressedSortedTable, can_store_keys_with_large_differences) {
+    std::vector<KeyType> keys = { 0, 1, 1u << 31, UINT32_MAX - 1, UINT32_MAX };
+    for (size_t i = 0; i < keys.size(); i++)
+        table->insert(keys[i], int(i));
+
+    for (size_t i = 0; i < keys.size(); i++)
+        ASSERT_EQ(int(i), table->find(keys[i])->second);
+}
+
+TEST_F(TestCompressedSortedTable, dense_keys_take_less_memory_than_uncompressed) {
+    insertKeys(10000, 1);
+
+    ASSERT_LT(getKeysMemorySize() * 3, 10000 * sizeof(KeyType));
+}
+
+TEST(TestCompressedSortedTableBuild, can_build_table_from_sorted_range) {
+    std::vector<std::pair<KeyType, std::string>> elems;
+    for (KeyType i = 0; i < 300; i++)
+        elems.push_back(std::make_pair(i * 5, std::to_string(i)));
+
+    CompressedSortedTable<std::string> table(elems.begin(), elems.end());
+
+    ASSERT_EQ(300, table.getSize());
+    for (KeyType i = 0; i < 300; i++)
+        ASSERT_EQ(std::to_string(i), table.find(i * 5)->second);
+}
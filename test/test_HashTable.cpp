@@ -14,7 +14,7 @@ public:
     std::vector<KeyType> collisionKeys, notCollisionKeys;
 
     TestHashTable() : HashTableTestType(3) {  // capacity = 2^3
-        this->a = 1;  // in this case there are a lot of collisions
+        this->a = uint64_t(1) << W;  // in this case there are a lot of collisions, hash(key) = key >> (W - M)
         collisionKeys = { 0, 1, 2, 3, 4, 5 };  // give collisions
         notCollisionKeys = {
             size_t(1) << (W - M),
@@ -129,6 +129,52 @@ TYPED_TEST_P(TestHashTable, hash_table_is_iterable_2) {
     ASSERT_EQ(5, ch);
 }
 
+TYPED_TEST_P(TestHashTable, size_is_correct_after_repack_if_elements_were_erased) {
+    for (int i = 0; i < 4; i++)
+        table->insert(notCollisionKeys[i], 'a');
+    table->erase(notCollisionKeys[0]);
+    table->erase(notCollisionKeys[1]);
+
+    for (KeyType key = 0; key < 10; key++)  // repack is called
+        table->insert(key, 'b');
+
+    ASSERT_EQ(12, table->getSize());
+    ASSERT_EQ(table->end(), table->find(notCollisionKeys[0]));
+}
+
+TYPED_TEST_P(TestHashTable, table_is_reseeded_if_probe_sequences_are_long) {
+    HashParameterGenerator::seed(1);  // new parameters are the same in every run
+    // all keys give collisions because "a" is bad
+    for (KeyType key = 0; key < 300; key++)
+        table->insert(key, 'a');
+
+    ASSERT_EQ(1, table->getReseedsCount());
+    for (KeyType key = 0; key < 300; key++)
+        ASSERT_EQ('a', table->find(key)->second);
+    // it is about 150 with bad "a"
+    ASSERT_LT(table->getMaxProbeLength(), this->MAX_PROBE_LENGTH_PER_DEG * this->M);
+    ASSERT_LT(table->getMaxProbeLength(), 16);
+}
+
+TYPED_TEST_P(TestHashTable, table_is_not_reseeded_if_auto_reseeding_is_disabled) {
+    table->setAutoReseeding(false);
+
+    for (KeyType key = 0; key < 300; key++)
+        table->insert(key, 'a');
+
+    ASSERT_EQ(0, table->getReseedsCount());
+    ASSERT_GT(table->getMaxProbeLength(), 100);
+}
+
+TYPED_TEST_P(TestHashTable, table_is_not_reseeded_if_keys_are_good) {
+    this->a = 0x9E3779B97F4A7C15;
+
+    for (KeyType key = 0; key < 10000; key++)
+        table->insert(key, 'a');
+
+    ASSERT_EQ(0, table->getReseedsCount());
+}
+
 REGISTER_TYPED_TEST_SUITE_P(TestHashTable,
     can_insert_and_find_first_element_if_collision,
     can_insert_and_find_second_element_if_collision,
@@ -139,7 +185,11 @@ REGISTER_TYPED_TEST_SUITE_P(TestHashTable,
     can_repack_table_if_it_is_almost_filled,
     repack_dont_break_table,
     hash_table_is_iterable,
-    hash_table_is_iterable_2
+    hash_table_is_iterable_2,
+    size_is_correct_after_repack_if_elements_were_erased,
+    table_is_reseeded_if_probe_sequences_are_long,
+    table_is_not_reseeded_if_auto_reseeding_is_disabled,
+    table_is_not_reseeded_if_keys_are_good
 );
 
 typedef ::testing::Types<HashTableOpenAddressing<char>, HashTableSeparateChaining<char>> TestHashTableTypes;
@@ -157,4 +207,54 @@ TEST_F(TestHashTableOpenAddressing, can_repack_table_if_insert_is_called_and_emp
     table->insert(collisionKeys[3], char('a' + 3));
 
     ASSERT_GT(storage.size(), size);
-}
\ No newline at end of file
+}
+
+typedef TestHashTable<HashTableSeparateChaining<char>> TestHashTableSeparateChaining;
+
+TEST_F(TestHashTableSeparateChaining, filter_rejects_missing_keys) {
+    table->setFilterEnabled(true);
+    for (KeyType key = 0; key < 1000; key++)
+        table->insert(key, 'a');
+
+    for (KeyType key = 1000; key < 10000; key++)
+        ASSERT_EQ(table->end(), table->find(key));
+
+    ASSERT_GT(table->getFilter().getRejectsCount(), 8000);
+    ASSERT_LT(table->getFilter().getFalsePositiveRate(), 0.05);
+}
+
+TEST_F(TestHashTableSeparateChaining, filter_is_rebuilt_on_repack) {
+    table->setFilterEnabled(true);
+    size_t rebuildsCount = table->getFilter().getRebuildsCount();
+
+    for (KeyType key = 0; key < 1000; key++)
+        table->insert(key, 'a');
+
+    ASSERT_GT(table->getFilter().getRebuildsCount(), rebuildsCount);
+    for (KeyType key = 0; key < 1000; key++)
+        ASSERT_EQ('a', table->find(key)->second);
+}
+
+TEST_F(TestHashTableSeparateChaining, erased_keys_are_not_found_if_filter_is_enabled) {
+    table->setFilterEnabled(true);
+    for (KeyType key = 0; key < 1000; key++)
+        table->insert(key, 'a');
+
+    for (KeyType key = 0; key < 1000; key += 2)
+        table->erase(key);
+
+    for (KeyType key = 0; key < 1000; key++)
+        ASSERT_EQ(key % 2 == 0, table->end() == table->find(key));
+}
+
+TEST(TestHashTableHash, keys_with_many_zero_low_bits_dont_give_long_probe_sequences) {
+    HashTableOpenAddressing<int> table;
+    table.setAutoReseeding(false);
+
+    for (KeyType i = 0; i < 4096; i++)
+        table.insert(i << 20, 0);
+    for (KeyType i = 0; i < 4096; i++)
+        table.find(i << 20);
+
+    ASSERT_LT(table.getAverageProbeLength(), 4);
+}
@@ -0,0 +1,63 @@
+#include "HugePageAllocator.h"
+#include "SortedTable.h"
+#include "UnsortedTable.h"
+#include "HashTable.h"
+#include <cstdint>
+#include <vector>
+
+#include "gtest/gtest.h"
+
+TEST(TestHugePageAllocator, can_allocate_small_array) {
+    std::vector<int, HugePageAllocator<int>> v(100, 7);
+
+    ASSERT_EQ(7, v[99]);
+}
+
+TEST(TestHugePageAllocator, can_allocate_large_array) {
+    std::vector<int, HugePageAllocator<int>> v(size_t(1) << 20, 7);
+    v.back() = 8;
+
+    ASSERT_EQ(7, v.front());
+    ASSERT_EQ(8, v.back());
+}
+
+TEST(TestHugePageAllocator, large_array_is_aligned_by_huge_page) {
+    HugePageAllocator<int> allocator;
+    size_t n = HugePageAllocator<int>::HUGE_PAGE_SIZE;
+
+    int* ptr = allocator.allocate(n);
+
+#ifdef __linux__
+    ASSERT_EQ(0, reinterpret_cast<uintptr_t>(ptr) % HugePageAllocator<int>::HUGE_PAGE_SIZE);
+#endif
+    allocator.deallocate(ptr, n);
+}
+
+TEST(TestHugePageAllocator, can_allocate_with_huge_tlb_or_fall_back) {
+    std::vector<int, HugePageAllocator<int, true>> v(size_t(1) << 20, 7);
+
+    ASSERT_EQ(7, v.back());
+}
+
+#define TEST_TABLE_WITH_HUGE_PAGES(TableType)                                                  \
+TEST(TestHugePageAllocator, can_use_##TableType) {                                             \
+    TableType<int, HugePageAllocator<int>> table;                                              \
+    for (KeyType i = 0; i < 100000; i++)                                                       \
+        table.insertWithoutSearch(i, int(i));                                                  \
+                                                                                               \
+    for (KeyType i = 0; i < 100000; i += 1000)                                                 \
+        ASSERT_EQ(int(i), table.find(i)->second);                                              \
+    ASSERT_EQ(table.end(), table.find(100000));                                                \
+}
+
+TEST_TABLE_WITH_HUGE_PAGES(SortedTable)
+TEST_TABLE_WITH_HUGE_PAGES(HashTableOpenAddressing)
+TEST_TABLE_WITH_HUGE_PAGES(HashTableSeparateChaining)
+
+TEST(TestHugePageAllocator, can_use_UnsortedTable) {
+    UnsortedTable<int, HugePageAllocator<int>> table;
+    for (KeyType i = 0; i < 1000; i++)
+        table.insert(i, int(i));
+
+    ASSERT_EQ(999, table.find(999)->second);
+}
@@ -0,0 +1,150 @@
+#include "LsmSortedTable.h"
+#include <map>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "gtest/gtest.h"
+
+class TestLsmSortedTable : public LsmSortedTable<int>, public testing::Test {
+
+public:
+
+    LsmSortedTable<int>* table = this;
+    // it is kept between calls of checkRandomOperations
+    std::map<KeyType, int> reference;
+
+    // random insertions and erasures, std::map is a reference
+    void checkRandomOperations(size_t operationsCount, KeyType maxKey, unsigned seed = 1) {
+        std::default_random_engine randGen(seed);
+        std::uniform_int_distribution<KeyType> dist(0, maxKey);
+        for (size_t i = 0; i < operationsCount; i++) {
+            KeyType key = dist(randGen);
+            if (i % 3 == 2) {
+                ASSERT_EQ(reference.erase(key) == 1, table->erase(key));
+            }
+            else {
+                auto insRes = table->insert(key, int(i));
+                ASSERT_EQ(reference.insert(std::make_pair(key, int(i))).second, insRes.second);
+            }
+        }
+
+        ASSERT_EQ(reference.size(), table->getSize());
+        for (KeyType key = 0; key <= maxKey; key++) {
+            auto it = table->find(key);
+            if (reference.count(key) == 0)
+                ASSERT_EQ(table->end(), it);
+            else
+                ASSERT_EQ(reference[key], it->second);
+        }
+        auto refIt = reference.begin();
+        for (auto it = table->begin(); it != table->end(); ++it, ++refIt) {
+            ASSERT_EQ(refIt->first, it->first);
+            ASSERT_EQ(refIt->second, it->second);
+        }
+        ASSERT_EQ(reference.end(), refIt);
+    }
+
+};
+
+TEST_F(TestLsmSortedTable, buffer_is_flushed_to_run_if_it_is_full) {
+    for (KeyType i = 0; i < BUFFER_CAPACITY + 1; i++)
+        table->insert(i, 0);
+
+    ASSERT_EQ(1, getRunsCount());
+}
+
+TEST_F(TestLsmSortedTable, runs_are_merged) {
+    for (KeyType i = 0; i < 100 * BUFFER_CAPACITY; i++)
+        table->insert(i, 0);
+
+    ASSERT_LT(getRunsCount(), 10);
+}
+
+TEST_F(TestLsmSortedTable, can_find_element_in_run) {
+    for (KeyType i = 0; i < 10 * BUFFER_CAPACITY; i++)
+        table->insert(i, int(i));
+
+    for (KeyType i = 0; i < 10 * BUFFER_CAPACITY; i++)
+        ASSERT_EQ(int(i), table->find(i)->second);
+}
+
+TEST_F(TestLsmSortedTable, tombstone_hides_element_in_run) {
+    for (KeyType i = 0; i < 2 * BUFFER_CAPACITY; i++)
+        table->insert(i, int(i));
+
+    table->erase(5);
+
+    ASSERT_EQ(table->end(), table->find(5));
+    ASSERT_EQ(2 * BUFFER_CAPACITY - 1, table->getSize());
+}
+
+TEST_F(TestLsmSortedTable, can_insert_erased_key_again) {
+    for (KeyType i = 0; i < 2 * BUFFER_CAPACITY; i++)
+        table->insert(i, int(i));
+    table->erase(5);
+
+    auto insRes = table->insert(5, 100);
+
+    ASSERT_TRUE(insRes.second);
+    ASSERT_EQ(100, table->find(5)->second);
+}
+
+TEST_F(TestLsmSortedTable, iterator_got_by_find_can_be_incremented) {
+    for (KeyType i = 0; i < 4 * BUFFER_CAPACITY; i++)
+        table->insert(4 * BUFFER_CAPACITY - i, int(i));
+
+    auto it = table->find(10);
+    ++it;
+
+    ASSERT_EQ(11, it->first);
+}
+
+TEST_F(TestLsmSortedTable, can_find_range_by_lower_bound) {
+    for (KeyType i = 0; i < 4 * BUFFER_CAPACITY; i++)
+        table->insert(2 * i, 0);
+    table->erase(20);
+
+    std::vector<KeyType> keys;
+    for (auto it = table->lowerBound(17); it != table->end() && it->first < 26; ++it)
+        keys.push_back(it->first);
+
+    ASSERT_EQ(std::vector<KeyType>({ 18, 22, 24 }), keys);
+}
+
+TEST_F(TestLsmSortedTable, compact_merges_all_runs) {
+    checkRandomOperations(10000, 3000);
+
+    table->compact();
+
+    ASSERT_EQ(1, getRunsCount());
+    checkRandomOperations(1000, 3000, 2);
+}
+
+TEST_F(TestLsmSortedTable, random_operations_with_incremental_merges) {
+    checkRandomOperations(50000, 10000);
+}
+
+TEST_F(TestLsmSortedTable, random_operations_with_merges_at_once) {
+    setMergeStepsPerOperation(0);
+
+    checkRandomOperations(50000, 10000);
+}
+
+TEST_F(TestLsmSortedTable, random_operations_with_slow_merges) {
+    setMergeStepsPerOperation(1);
+
+    checkRandomOperations(50000, 10000);
+}
+
+TEST(TestLsmSortedTableCopy, can_copy_table) {
+    LsmSortedTable<std::string> table;
+    for (KeyType i = 0; i < 1000; i++)
+        table.insert(i, std::to_string(i));
+
+    LsmSortedTable<std::string> copy(table);
+    table.clear();
+
+    ASSERT_EQ("500", copy.find(500)->second);
+    ASSERT_EQ(1000, copy.getSize());
+}
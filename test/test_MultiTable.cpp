@@ -0,0 +1,233 @@
+#include "MultiTable.h"
+#include <map>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "gtest/gtest.h"
+
+// random insertions, appends and erasures, std::multimap is a reference
+template <class TableType>
+void checkRandomOperations(TableType& table, size_t operationsCount, KeyType maxKey) {
+    std::multimap<KeyType, std::string> reference;
+    std::default_random_engine randGen(1);
+    std::uniform_int_distribution<KeyType> dist(0, maxKey);
+    for (size_t i = 0; i < operationsCount; i++) {
+        KeyType key = dist(randGen);
+        if (i % 7 == 6) {
+            ASSERT_EQ(reference.erase(key), table.erase(key));
+        }
+        else if (i % 7 == 5) {
+            auto it = table.find(key);
+            auto refIt = reference.find(key);
+            if (refIt != reference.end()) {
+                reference.erase(refIt);
+                table.eraseWithoutSearch(it);
+            }
+        }
+        else if (i % 7 == 4) {
+            std::vector<std::string> values(i % 5, std::to_string(i));
+            table.append(key, values.begin(), values.end());
+            for (const std::string& value : values)
+                reference.insert(std::make_pair(key, value));
+        }
+        else {
+            table.insert(key, std::to_string(i));
+            reference.insert(std::make_pair(key, std::to_string(i)));
+        }
+    }
+
+    ASSERT_EQ(reference.size(), table.getSize());
+    for (KeyType key = 0; key <= maxKey; key++) {
+        ASSERT_EQ(reference.count(key), table.count(key));
+        auto range = table.equalRange(key);
+        auto refRange = reference.equal_range(key);
+        for (; refRange.first != refRange.second; ++refRange.first, ++range.first) {
+            ASSERT_NE(range.second, range.first);
+            ASSERT_EQ(key, range.first->first);
+            ASSERT_EQ(refRange.first->second, range.first->second);  // values are in order of insertion
+        }
+        ASSERT_EQ(range.second, range.first);
+    }
+    size_t ch = 0;
+    for (auto it = table.begin(); it != table.end(); ++it, ++ch) {}
+    ASSERT_EQ(reference.size(), ch);
+}
+
+class TestSortedMultiTable : public SortedMultiTable<int>, public testing::Test {
+
+public:
+
+    SortedMultiTable<int>* table = this;
+
+};
+
+class TestHashMultiTable : public HashMultiTable<int>, public testing::Test {
+
+public:
+
+    HashMultiTable<int>* table = this;
+
+};
+
+TEST_F(TestSortedMultiTable, can_insert_several_values_of_key) {
+    table->insert(1, 10);
+    table->insert(2, 20);
+    table->insert(1, 11);
+
+    ASSERT_EQ(3, table->getSize());
+    ASSERT_EQ(2, table->count(1));
+    ASSERT_EQ(10, table->find(1)->second);
+}
+
+TEST_F(TestSortedMultiTable, values_of_key_are_in_order_of_insertion) {
+    std::vector<int> values = { 3, 4, 5 };
+    table->insert(1, 1);
+    table->insert(0, 0);
+    table->insert(1, 2);
+    table->append(1, values.begin(), values.end());
+
+    auto range = table->equalRange(1);
+
+    ASSERT_EQ(5, range.second - range.first);
+    for (int i = 1; range.first != range.second; ++range.first, ++i)
+        ASSERT_EQ(i, range.first->second);
+}
+
+TEST_F(TestSortedMultiTable, erase_removes_all_values_of_key) {
+    for (int i = 0; i < 5; i++) {
+        table->insert(1, i);
+        table->insert(2, i);
+    }
+
+    ASSERT_EQ(5, table->erase(1));
+    ASSERT_EQ(0, table->erase(1));
+    ASSERT_EQ(table->end(), table->find(1));
+    ASSERT_EQ(5, table->count(2));
+}
+
+TEST_F(TestSortedMultiTable, equal_range_of_missing_key_is_empty) {
+    table->insert(1, 1);
+    table->insert(3, 3);
+
+    auto range = table->equalRange(2);
+
+    ASSERT_EQ(range.first, range.second);
+    ASSERT_EQ(0, table->count(2));
+}
+
+TEST_F(TestSortedMultiTable, can_do_many_random_operations) {
+    SortedMultiTable<std::string> strTable;
+    checkRandomOperations(strTable, 20000, 300);
+}
+
+TEST_F(TestHashMultiTable, can_insert_several_values_of_key) {
+    table->insert(1, 10);
+    table->insert(2, 20);
+    table->insert(1, 11);
+
+    ASSERT_EQ(3, table->getSize());
+    ASSERT_EQ(2, table->getKeysCount());
+    ASSERT_EQ(2, table->count(1));
+    ASSERT_EQ(10, table->find(1)->second);
+}
+
+TEST_F(TestHashMultiTable, values_of_key_are_in_order_of_insertion) {
+    std::vector<int> values = { 3, 4, 5 };
+    table->insert(1, 1);
+    table->insert(0, 0);  // the group of key 1 is not the last one
+    table->insert(1, 2);
+    table->append(1, values.begin(), values.end());
+
+    auto range = table->equalRange(1);
+
+    int i = 1;
+    for (; range.first != range.second; ++range.first, ++i)
+        ASSERT_EQ(i, range.first->second);
+    ASSERT_EQ(6, i);
+}
+
+TEST_F(TestHashMultiTable, values_of_key_are_contiguous) {
+    for (int i = 0; i < 100; i++)
+        for (KeyType key = 0; key < 10; key++)
+            table->insert(key, i);
+
+    for (KeyType key = 0; key < 10; key++) {
+        auto it = table->find(key);
+        const std::pair<KeyType, int>* first = &*it;
+        for (int i = 0; i < 100; i++, ++it)
+            ASSERT_EQ(first + i, &*it);
+    }
+}
+
+TEST_F(TestHashMultiTable, erase_removes_all_values_of_key) {
+    for (int i = 0; i < 5; i++) {
+        table->insert(1, i);
+        table->insert(2, i);
+    }
+
+    ASSERT_EQ(5, table->erase(1));
+    ASSERT_EQ(0, table->erase(1));
+    ASSERT_EQ(table->end(), table->find(1));
+    ASSERT_EQ(5, table->count(2));
+    ASSERT_EQ(1, table->getKeysCount());
+}
+
+TEST_F(TestHashMultiTable, erasing_of_last_value_removes_key) {
+    table->insert(1, 1);
+
+    table->eraseWithoutSearch(table->find(1));
+
+    ASSERT_TRUE(table->isEmpty());
+    ASSERT_EQ(0, table->getKeysCount());
+    ASSERT_EQ(table->end(), table->begin());
+}
+
+TEST_F(TestHashMultiTable, arena_is_compacted) {
+    // every insertion moves group of its key to the end of arena
+    for (int i = 0; i < 1000; i++)
+        for (KeyType key = 0; key < 10; key++)
+            table->insert(key, i);
+
+    ASSERT_LE(holesCount * 2, arena.size());
+    for (KeyType key = 0; key < 10; key++)
+        ASSERT_EQ(1000, table->count(key));
+}
+
+TEST_F(TestHashMultiTable, arena_is_compacted_when_full_group_grows) {
+    for (int i = 0; i < 8; i++)
+        table->insert(100, i);
+    for (KeyType key = 0; key < 60; key++)
+        table->insert(key, int(key));
+    for (KeyType key = 0; key < 59; key++)
+        table->erase(key);
+
+    table->insert(100, 8);  // the group of key 100 is full and it is not the last one
+
+    ASSERT_EQ(9, table->count(100));
+    auto range = table->equalRange(100);
+    for (int i = 0; range.first != range.second; ++range.first, ++i)
+        ASSERT_EQ(i, range.first->second);
+    ASSERT_EQ(59, table->find(59)->second);
+}
+
+TEST_F(TestHashMultiTable, can_insert_after_clear) {
+    for (KeyType key = 0; key < 2000; key++)
+        table->insert(key % 100, int(key));
+
+    table->clear();
+    table->insert(5, 5);
+
+    ASSERT_EQ(1, table->getSize());
+    ASSERT_EQ(5, table->find(5)->second);
+}
+
+TEST_F(TestHashMultiTable, can_do_many_random_operations) {
+    HashMultiTable<std::string> strTable;
+    checkRandomOperations(strTable, 20000, 300);
+}
+
+TEST_F(TestHashMultiTable, can_do_many_random_operations_with_repacks) {
+    HashMultiTable<std::string> strTable;
+    checkRandomOperations(strTable, 50000, 20000);
+}
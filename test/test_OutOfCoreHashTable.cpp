@@ -0,0 +1,184 @@
+#include "OutOfCoreHashTable.h"
+#include <filesystem>
+#include <map>
+#include <random>
+#include <set>
+#include <string>
+#include <vector>
+
+#include "gtest/gtest.h"
+
+class TestOutOfCoreHashTable : public OutOfCoreHashTable<int>, public testing::Test {
+
+public:
+
+    OutOfCoreHashTable<int>* table = this;
+
+    TestOutOfCoreHashTable() : OutOfCoreHashTable<int>(1 << 16) {}  // about 2700 elements in memory
+
+    // random insertions and erasures, std::map is a reference
+    void checkRandomOperations(size_t operationsCount, KeyType maxKey) {
+        std::map<KeyType, int> reference;
+        std::default_random_engine randGen(1);
+        std::uniform_int_distribution<KeyType> dist(0, maxKey);
+        for (size_t i = 0; i < operationsCount; i++) {
+            KeyType key = dist(randGen);
+            if (i % 3 == 2) {
+                ASSERT_EQ(reference.erase(key) == 1, table->erase(key));
+            }
+            else {
+                auto insRes = table->insert(key, int(i));
+                ASSERT_EQ(reference.insert(std::make_pair(key, int(i))).second, insRes.second);
+            }
+        }
+
+        ASSERT_EQ(reference.size(), table->getSize());
+        for (KeyType key = 0; key <= maxKey; key++) {
+            auto it = table->find(key);
+            if (reference.count(key) == 0)
+                ASSERT_EQ(table->end(), it);
+            else
+                ASSERT_EQ(reference[key], it->second);
+        }
+        std::map<KeyType, int> iterated;
+        for (auto it = table->begin(); it != table->end(); ++it)
+            ASSERT_TRUE(iterated.insert(*it).second);
+        ASSERT_EQ(reference, iterated);
+    }
+
+};
+
+TEST_F(TestOutOfCoreHashTable, table_is_not_spilled_if_it_fits_in_budget) {
+    for (KeyType i = 0; i < 1000; i++)
+        table->insert(i, int(i));
+
+    ASSERT_EQ(0, getSpilledPartitionsCount());
+    ASSERT_LE(getMemoryUsage(), getMemoryBudget());
+}
+
+TEST_F(TestOutOfCoreHashTable, partitions_are_spilled_if_budget_is_exceeded) {
+    for (KeyType i = 0; i < 20000; i++)
+        table->insert(i, int(i));
+
+    ASSERT_GT(getPartitionsCount(), 8);
+    ASSERT_GT(getSpilledPartitionsCount(), 0);
+    ASSERT_LE(getMemoryUsage(), getMemoryBudget());
+    ASSERT_FALSE(spillDirectory.empty());
+}
+
+TEST_F(TestOutOfCoreHashTable, can_find_elements_of_spilled_partitions) {
+    for (KeyType i = 0; i < 20000; i++)
+        table->insert(i, int(i));
+
+    for (KeyType i = 0; i < 20000; i++)
+        ASSERT_EQ(int(i), table->find(i)->second);
+    ASSERT_GT(getLoadsCount(), 0);
+}
+
+TEST_F(TestOutOfCoreHashTable, negative_lookups_dont_load_most_partitions) {
+    for (KeyType i = 0; i < 20000; i++)
+        table->insert(i, int(i));
+    size_t loadsCount = getLoadsCount();
+
+    for (KeyType i = 20000; i < 30000; i++)
+        ASSERT_EQ(table->end(), table->find(i));
+
+    ASSERT_GT(getFilterSkipsCount(), 0);
+    ASSERT_LT(getLoadsCount() - loadsCount, 1000);
+}
+
+TEST_F(TestOutOfCoreHashTable, insertion_to_spilled_partitions_doesnt_load_most_of_them) {
+    for (KeyType i = 0; i < 20000; i++)
+        table->insert(2 * i, int(i));
+    size_t loadsCount = getLoadsCount();
+
+    for (KeyType i = 0; i < 100; i++)
+        table->insert(2 * i + 1, 0);
+
+    ASSERT_LT(getLoadsCount() - loadsCount, 10);  // false positives of filters and splits
+    ASSERT_EQ(20100, table->getSize());
+    for (KeyType i = 0; i < 100; i++)
+        ASSERT_EQ(0, table->find(2 * i + 1)->second);
+}
+
+TEST_F(TestOutOfCoreHashTable, iterator_is_valid_after_its_partition_is_spilled) {
+    for (KeyType i = 0; i < 20000; i++)
+        table->insert(i, int(i));
+
+    auto it = table->find(5);
+    for (KeyType i = 0; i < 20000; i += 7)  // partitions are loaded and spilled
+        table->find(i);
+
+    ASSERT_EQ(5, it->first);
+    ASSERT_EQ(5, it->second);
+}
+
+TEST_F(TestOutOfCoreHashTable, iteration_is_not_broken_by_searches_in_other_partitions) {
+    for (KeyType i = 0; i < 20000; i++)
+        table->insert(i, int(i));
+
+    std::set<KeyType> visited;
+    size_t ch = 0;
+    for (auto it = table->begin(); it != table->end(); ++it, ++ch) {
+        ASSERT_EQ(int(it->first), it->second);
+        visited.insert(it->first);
+        if (ch % 100 == 0)  // partitions are spilled and loaded, the current one too
+            for (KeyType i = KeyType(ch % 1000); i < 20000; i += 1000)
+                table->find(i);
+    }
+
+    ASSERT_EQ(20000, ch);
+    ASSERT_EQ(20000, visited.size());
+}
+
+TEST_F(TestOutOfCoreHashTable, erased_element_is_not_found_after_spill) {
+    for (KeyType i = 0; i < 20000; i++)
+        table->insert(i, int(i));
+
+    for (KeyType i = 0; i < 20000; i += 2)
+        table->erase(i);
+    for (KeyType i = 0; i < 20000; i++)  // all partitions are spilled and loaded
+        table->find(i);
+
+    for (KeyType i = 0; i < 20000; i++) {
+        if (i % 2 == 0)
+            ASSERT_EQ(table->end(), table->find(i));
+        else
+            ASSERT_EQ(int(i), table->find(i)->second);
+    }
+    ASSERT_EQ(10000, table->getSize());
+}
+
+TEST_F(TestOutOfCoreHashTable, clear_removes_files) {
+    for (KeyType i = 0; i < 20000; i++)
+        table->insert(i, int(i));
+    std::string directory = spillDirectory;
+
+    table->clear();
+
+    ASSERT_FALSE(std::filesystem::exists(directory));
+    ASSERT_TRUE(table->isEmpty());
+    ASSERT_EQ(table->end(), table->find(5));
+    checkRandomOperations(1000, 100);
+}
+
+TEST_F(TestOutOfCoreHashTable, random_operations) {
+    checkRandomOperations(100000, 30000);
+}
+
+TEST(TestOutOfCoreHashTableStrings, can_spill_strings_to_given_directory) {
+    std::filesystem::path base = std::filesystem::temp_directory_path() / "test_out_of_core_table";
+    std::filesystem::create_directories(base);
+    {
+        OutOfCoreHashTable<std::string> table(1 << 16, base.string());
+        for (KeyType i = 0; i < 10000; i++)
+            table.insert(i, std::string(i % 50, 'a') + std::to_string(i));
+
+        ASSERT_GT(table.getSpilledPartitionsCount(), 0);
+        ASSERT_FALSE(std::filesystem::is_empty(base));
+        for (KeyType i = 0; i < 10000; i++)
+            ASSERT_EQ(std::string(i % 50, 'a') + std::to_string(i), table.find(i)->second);
+    }
+    ASSERT_TRUE(std::filesystem::is_empty(base));
+    std::filesystem::remove(base);
+}
@@ -0,0 +1,313 @@
+#include "SortedTable.h"
+#include <iterator>
+#include <string>
+#include <vector>
+
+#include "gtest/gtest.h"
+
+class TestSortedTable : public SortedTable<std::string>, public testing::Test {
+
+public:
+
+    SortedTable<std::string>* table = this;
+
+    TestSortedTable() {
+        for (KeyType i = 0; i < 10; i++)
+            table->insert(i, std::string(1, char('a' + i)));
+    }
+
+};
+
+TEST_F(TestSortedTable, can_erase_if) {
+    size_t erased = table->eraseIf([](const std::pair<KeyType, std::string>& elem) {
+        return elem.first % 2 == 0;
+    });
+
+    ASSERT_EQ(5, erased);
+    ASSERT_EQ(5, table->getSize());
+    ASSERT_EQ(table->end(), table->find(4));
+    ASSERT_EQ("f", table->find(5)->second);
+}
+
+TEST_F(TestSortedTable, erase_if_keeps_order) {
+    table->eraseIf([](const std::pair<KeyType, std::string>& elem) {
+        return elem.first % 3 == 0;
+    });
+
+    std::vector<KeyType> keys;
+    for (auto it = table->begin(); it != table->end(); ++it)
+        keys.push_back(it->first);
+    ASSERT_EQ(std::vector<KeyType>({ 1, 2, 4, 5, 7, 8 }), keys);
+}
+
+TEST_F(TestSortedTable, can_erase_keys) {
+    std::vector<KeyType> keys = { 1, 3, 4, 9, 15 };
+
+    size_t erased = table->eraseKeys(keys.begin(), keys.end());
+
+    ASSERT_EQ(4, erased);
+    ASSERT_EQ(6, table->getSize());
+    ASSERT_EQ(table->end(), table->find(9));
+    ASSERT_EQ("c", table->find(2)->second);
+}
+
+TEST_F(TestSortedTable, lazy_erasing_dont_remove_cell) {
+    table->setLazyErasing(true);
+
+    table->erase(3);
+
+    ASSERT_EQ(table->end(), table->find(3));
+    ASSERT_EQ(9, table->getSize());
+    ASSERT_EQ(10, storage.size());
+}
+
+TEST_F(TestSortedTable, lazily_erased_element_is_not_iterated) {
+    table->setLazyErasing(true);
+
+    table->erase(0);
+    table->erase(5);
+
+    int ch = 0;
+    for (auto it = table->begin(); it != table->end(); ++it, ++ch)
+        ASSERT_TRUE(it->first != 0 && it->first != 5);
+    ASSERT_EQ(8, ch);
+}
+
+TEST_F(TestSortedTable, can_insert_lazily_erased_key_again) {
+    table->setLazyErasing(true);
+    table->erase(3);
+
+    auto insRes = table->insert(3, "z");
+
+    ASSERT_TRUE(insRes.second);
+    ASSERT_EQ("z", table->find(3)->second);
+    ASSERT_EQ(10, table->getSize());
+}
+
+TEST_F(TestSortedTable, table_is_compacted_if_a_lot_of_elements_are_erased_lazily) {
+    table->setLazyErasing(true);
+
+    for (KeyType i = 0; i < 3; i++)
+        table->erase(i);
+
+    ASSERT_EQ(7, table->getSize());
+    ASSERT_EQ(7, storage.size());
+    ASSERT_EQ("d", table->find(3)->second);
+}
+
+TEST_F(TestSortedTable, disabling_lazy_erasing_compacts_table) {
+    table->setLazyErasing(true);
+    table->erase(3);
+
+    table->setLazyErasing(false);
+
+    ASSERT_EQ(9, storage.size());
+    ASSERT_EQ(table->end(), table->find(3));
+}
+
+
+// search strategies are tested for different distributions of keys
+TEST_F(TestSortedTable, filter_rejects_missing_keys) {
+    table->setFilterEnabled(true);
+
+    for (KeyType i = 10; i < 10000; i++)
+        ASSERT_EQ(table->end(), table->find(i));
+
+    ASSERT_GT(getFilter().getRejectsCount(), 9000);
+    ASSERT_LT(getFilter().getFalsePositiveRate(), 0.05);
+    ASSERT_GT(getFilter().getMemorySize(), 0);
+}
+
+TEST_F(TestSortedTable, can_find_keys_if_filter_is_enabled) {
+    table->setFilterEnabled(true);
+    for (KeyType i = 10; i < 10000; i++)  // the filter is rebuilt several times
+        table->insert(i, "x");
+
+    for (KeyType i = 0; i < 10000; i++)
+        ASSERT_NE(table->end(), table->find(i));
+    ASSERT_GT(getFilter().getRebuildsCount(), 1);
+}
+
+TEST_F(TestSortedTable, erased_keys_are_not_found_if_filter_is_enabled) {
+    setLazyErasing(true);
+    table->setFilterEnabled(true);
+    for (KeyType i = 10; i < 2000; i++)
+        table->insert(i, "x");
+
+    for (KeyType i = 0; i < 2000; i += 2)
+        table->erase(i);
+    std::vector<KeyType> keys = { 1, 3, 5 };
+    table->eraseKeys(keys.begin(), keys.end());
+
+    for (KeyType i = 0; i < 2000; i++)
+        ASSERT_EQ(i % 2 == 0 || i < 6, table->end() == table->find(i));
+    ASSERT_GT(getFilter().getRebuildsCount(), 1);  // a half of keys were erased
+}
+
+TEST_F(TestSortedTable, filter_is_empty_after_clear) {
+    table->setFilterEnabled(true);
+
+    table->clear();
+    table->insert(20, "x");
+
+    ASSERT_EQ(table->end(), table->find(5));
+    ASSERT_EQ("x", table->find(20)->second);
+    ASSERT_EQ(2, getFilter().getRejectsCount());  // searches of 20 by insert and of 5
+}
+
+TEST_F(TestSortedTable, filter_can_be_disabled) {
+    table->setFilterEnabled(true);
+
+    table->setFilterEnabled(false);
+
+    ASSERT_FALSE(table->isFilterEnabled());
+    ASSERT_EQ(table->end(), table->find(20));
+    ASSERT_EQ("b", table->find(1)->second);
+    ASSERT_EQ(0, getFilter().getMemorySize());
+}
+
+class TestSortedTableSearchStrategy : public testing::TestWithParam<SortedTableSearchStrategy> {
+
+public:
+
+    // all keys are inserted to table with step, keys + 1 are not inserted
+    void checkSearch(const std::vector<KeyType>& keys) {
+        SortedTable<int> table;
+        table.setSearchStrategy(GetParam());
+        for (size_t i = 0; i < keys.size(); i++)
+            table.insert(keys[i], int(i));
+
+        for (size_t i = 0; i < keys.size(); i++) {
+            ASSERT_EQ(int(i), table.find(keys[i])->second);
+            ASSERT_EQ(table.end(), table.find(keys[i] + 1));
+        }
+        ASSERT_EQ(table.end(), table.find(0));
+        ASSERT_EQ(table.end(), table.find(UINT32_MAX));
+    }
+
+};
+
+TEST_P(TestSortedTableSearchStrategy, can_find_uniform_keys) {
+    std::vector<KeyType> keys;
+    for (KeyType i = 1; i <= 1000; i++)
+        keys.push_back(i * 1000 + (i * 7919) % 500);
+
+    checkSearch(keys);
+}
+
+TEST_P(TestSortedTableSearchStrategy, can_find_clustered_keys) {
+    std::vector<KeyType> keys;
+    for (KeyType i = 1; i <= 1000; i++)
+        keys.push_back((i % 4) * 100000000 + i * 2);
+
+    checkSearch(keys);
+}
+
+TEST_P(TestSortedTableSearchStrategy, can_find_skewed_keys) {
+    std::vector<KeyType> keys;
+    for (KeyType i = 1; i <= 1000; i++)
+        keys.push_back(i * i * i);
+
+    checkSearch(keys);
+}
+
+TEST_P(TestSortedTableSearchStrategy, can_find_in_empty_and_small_tables) {
+    checkSearch({});
+    checkSearch({ 5 });
+    checkSearch({ 5, 7 });
+}
+
+INSTANTIATE_TEST_SUITE_P(Test, TestSortedTableSearchStrategy, testing::Values(
+    SortedTableSearchStrategy::BINARY,
+    SortedTableSearchStrategy::BRANCHLESS_BINARY,
+    SortedTableSearchStrategy::INTERPOLATION,
+    SortedTableSearchStrategy::INTERPOLATION_SEQUENTIAL,
+    SortedTableSearchStrategy::AUTO
+));
+
+TEST(TestSortedTableAutoSearchStrategy, chooses_interpolation_for_evenly_spaced_keys) {
+    SortedTable<int> table;
+    for (KeyType i = 0; i < 1000; i++)
+        table.insert(i * 10, 0);
+
+    table.setSearchStrategy(SortedTableSearchStrategy::AUTO);
+
+    ASSERT_EQ(SortedTableSearchStrategy::INTERPOLATION_SEQUENTIAL, table.getCurrentSearchStrategy());
+}
+
+TEST(TestSortedTableAutoSearchStrategy, chooses_binary_search_for_skewed_keys) {
+    SortedTable<int> table;
+    for (KeyType i = 0; i < 1000; i++)
+        table.insert(i * i * i, 0);
+
+    table.setSearchStrategy(SortedTableSearchStrategy::AUTO);
+
+    ASSERT_EQ(SortedTableSearchStrategy::BRANCHLESS_BINARY, table.getCurrentSearchStrategy());
+}
+
+TEST(TestSortedTableAutoSearchStrategy, samples_keys_again_if_table_grows) {
+    SortedTable<int> table;
+    table.setSearchStrategy(SortedTableSearchStrategy::AUTO);
+
+    for (KeyType i = 0; i < 1000; i++)
+        table.insert(i * 10, 0);
+    table.find(0);
+
+    ASSERT_EQ(SortedTableSearchStrategy::INTERPOLATION_SEQUENTIAL, table.getCurrentSearchStrategy());
+}
+
+TEST_F(TestSortedTable, find_batch_returns_the_same_as_find) {
+    std::vector<KeyType> keys;
+    for (KeyType i = 0; i < 100; i++)
+        keys.push_back((i * 7) % 23);  // keys 10..22 are missing, the last group is not full
+
+    std::vector<SortedTable<std::string>::iterator> results;
+    table->findBatch(keys.begin(), keys.end(), std::back_inserter(results));
+
+    ASSERT_EQ(keys.size(), results.size());
+    for (size_t i = 0; i < keys.size(); i++)
+        ASSERT_EQ(table->find(keys[i]), results[i]);
+}
+
+TEST_F(TestSortedTable, find_batch_in_large_table) {
+    SortedTable<int> largeTable;
+    for (KeyType i = 0; i < 100000; i++)
+        largeTable.insertWithoutSearch(i * 3, int(i));
+    std::vector<KeyType> keys;
+    for (KeyType i = 0; i < 1000; i++)
+        keys.push_back(i * 977 % 300005);
+
+    std::vector<SortedTable<int>::iterator> results;
+    largeTable.findBatch(keys.begin(), keys.end(), std::back_inserter(results));
+
+    for (size_t i = 0; i < keys.size(); i++) {
+        if (keys[i] % 3 == 0)
+            ASSERT_EQ(int(keys[i] / 3), results[i]->second);
+        else
+            ASSERT_EQ(largeTable.end(), results[i]);
+    }
+}
+
+TEST_F(TestSortedTable, find_batch_skips_lazily_erased_elements) {
+    table->setLazyErasing(true);
+    table->erase(4);
+    std::vector<KeyType> keys = { 3, 4, 5 };
+
+    std::vector<SortedTable<std::string>::iterator> results;
+    table->findBatch(keys.begin(), keys.end(), std::back_inserter(results));
+
+    ASSERT_EQ("d", results[0]->second);
+    ASSERT_EQ(table->end(), results[1]);
+    ASSERT_EQ("f", results[2]->second);
+}
+
+TEST_F(TestSortedTable, find_batch_in_empty_table) {
+    table->clear();
+    std::vector<KeyType> keys = { 1, 2 };
+
+    std::vector<SortedTable<std::string>::iterator> results;
+    table->findBatch(keys.begin(), keys.end(), std::back_inserter(results));
+
+    ASSERT_EQ(2, results.size());
+    ASSERT_EQ(table->end(), results[0]);
+}
@@ -0,0 +1,167 @@
+#include "StaticHashTable.h"
+#include <algorithm>
+#include <map>
+#include <random>
+#include <stdexcept>
+#include <string>
+
+#include "gtest/gtest.h"
+
+constexpr StaticHashTable<int, 100> makeSquaresTable() {
+    StaticHashTable<int, 100> table;
+    for (KeyType i = 0; i < 100; i++)
+        table.insert(i * 1000, int(i * i));
+    table.erase(5000);
+    return table;
+}
+
+constexpr auto SQUARES = makeSquaresTable();
+
+static_assert(SQUARES.getSize() == 99, "table is built at compile time");
+static_assert(SQUARES.find(7000)->second == 49, "element is found at compile time");
+static_assert(SQUARES.find(5000) == SQUARES.end(), "erased element is not found at compile time");
+static_assert(SQUARES.find(7) == SQUARES.end(), "missing element is not found at compile time");
+
+// erasures rebuild the table
+constexpr StaticHashTable<int, 10> makeChurnedTable() {
+    StaticHashTable<int, 10> table;
+    for (KeyType i = 0; i < 100; i++) {
+        table.insert(i, int(i));
+        if (i >= 5)
+            table.erase(i - 5);
+    }
+    return table;
+}
+
+constexpr auto CHURNED = makeChurnedTable();
+
+static_assert(CHURNED.getSize() == 5, "table is rebuilt at compile time");
+static_assert(CHURNED.find(97)->second == 97, "element is found after rebuild at compile time");
+static_assert(CHURNED.find(3) == CHURNED.end(), "erased element is not found after rebuild at compile time");
+
+class TestStaticHashTableChurn : public StaticHashTable<int, 64>, public testing::Test {
+
+public:
+
+    StaticHashTable<int, 64>* table = this;
+
+    // number of cells looked through by unsuccessful search
+    size_t getMissProbeLength(KeyType key) const {
+        size_t cell = hash(key);
+        size_t i = 1;
+        for (; i < TABLE_SIZE && (storage[cell].isFilled || storage[cell].isDeleted); i++)
+            cell = (cell + i) & MASK;
+        return i;
+    }
+
+};
+
+TEST(TestStaticHashTable, can_find_element_of_table_built_at_compile_time) {
+    for (KeyType i = 0; i < 100; i++) {
+        if (i == 5)
+            ASSERT_EQ(SQUARES.end(), SQUARES.find(i * 1000));
+        else
+            ASSERT_EQ(int(i * i), SQUARES.find(i * 1000)->second);
+    }
+}
+
+TEST(TestStaticHashTable, table_built_at_compile_time_is_iterable) {
+    int ch = 0;
+    for (auto it = SQUARES.begin(); it != SQUARES.end(); ++it, ++ch)
+        ASSERT_EQ(int(it->first / 1000 * (it->first / 1000)), it->second);
+
+    ASSERT_EQ(99, ch);
+}
+
+TEST(TestStaticHashTable, table_doesnt_allocate_memory) {
+    // at least Capacity cells are inline
+    ASSERT_GE(sizeof(StaticHashTable<int, 100>), 100 * sizeof(std::pair<KeyType, int>));
+}
+
+TEST(TestStaticHashTable, can_insert_capacity_elements) {
+    StaticHashTable<int, 10> table;
+
+    for (KeyType i = 0; i < 10; i++)
+        ASSERT_TRUE(table.insert(i, int(i)).second);
+
+    ASSERT_EQ(10, table.getSize());
+}
+
+TEST(TestStaticHashTable, throws_when_insert_to_full_table) {
+    StaticHashTable<int, 10> table;
+    for (KeyType i = 0; i < 10; i++)
+        table.insert(i, int(i));
+
+    ASSERT_THROW(table.insert(10, 10), std::length_error);
+    ASSERT_NO_THROW(table.insert(5, 5));  // key exists
+}
+
+TEST(TestStaticHashTable, can_insert_after_erase_in_full_table) {
+    StaticHashTable<int, 10> table;
+    for (KeyType i = 0; i < 10; i++)
+        table.insert(i, int(i));
+
+    table.erase(3);
+
+    ASSERT_NO_THROW(table.insert(10, 10));
+    ASSERT_EQ(10, table.find(10)->second);
+    ASSERT_EQ(table.end(), table.find(3));
+}
+
+TEST(TestStaticHashTable, can_search_after_many_insertions_and_erasures) {
+    StaticHashTable<std::string, 64> table;
+    std::map<KeyType, std::string> reference;
+    std::default_random_engine randGen(1);
+    std::uniform_int_distribution<KeyType> dist(0, 200);
+
+    for (int i = 0; i < 10000; i++) {
+        KeyType key = dist(randGen);
+        if (reference.size() == 64 || i % 2 == 1) {
+            ASSERT_EQ(reference.erase(key) == 1, table.erase(key));
+        }
+        else {
+            auto insRes = table.insert(key, std::to_string(i));
+            ASSERT_EQ(reference.insert(std::make_pair(key, std::to_string(i))).second, insRes.second);
+        }
+    }
+
+    ASSERT_EQ(reference.size(), table.getSize());
+    for (KeyType key = 0; key <= 200; key++) {
+        auto it = table.find(key);
+        if (reference.count(key) == 0)
+            ASSERT_EQ(table.end(), it);
+        else
+            ASSERT_EQ(reference[key], it->second);
+    }
+}
+
+TEST_F(TestStaticHashTableChurn, unsuccessful_searches_are_short_after_many_erasures) {
+    // every insertion takes a new key, so without rebuild all free cells become deleted
+    for (KeyType key = 0; key < 10000; key++) {
+        table->insert(key, int(key));
+        if (key >= 48)
+            table->erase(key - 48);
+    }
+
+    size_t maxProbeLength = 0;
+    for (KeyType key = 20000; key < 21000; key++) {
+        ASSERT_EQ(table->end(), table->find(key));
+        maxProbeLength = std::max(maxProbeLength, getMissProbeLength(key));
+    }
+    ASSERT_LT(maxProbeLength, 32);  // TABLE_SIZE = 128
+    ASSERT_EQ(48, table->getSize());
+    for (KeyType key = 10000 - 48; key < 10000; key++)
+        ASSERT_EQ(int(key), table->find(key)->second);
+}
+
+TEST(TestStaticHashTable, clear_removes_all_elements) {
+    StaticHashTable<std::string, 10> table;
+    for (KeyType i = 0; i < 10; i++)
+        table.insert(i, "a");
+
+    table.clear();
+
+    ASSERT_TRUE(table.isEmpty());
+    ASSERT_EQ(table.end(), table.begin());
+    ASSERT_EQ(table.end(), table.find(1));
+}
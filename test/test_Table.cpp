@@ -5,6 +5,10 @@
 #include "SortedTable.h"
 #include "UnsortedTable.h"
 #include "HashTable.h"
+#include "AdaptiveTable.h"
+#include "CompressedSortedTable.h"
+#include "LsmSortedTable.h"
+#include "OutOfCoreHashTable.h"
 
 #include "gtest/gtest.h"
 
@@ -25,6 +29,18 @@ TEST(test_case##HashTableOpenAddressing, test_name) {
 TEST(test_case##HashTableSeparateChaining, test_name) {                                        \
     func##test_case##test_name<HashTableSeparateChaining>();                                   \
 }                                                                                              \
+TEST(test_case##AdaptiveTable, test_name) {                                                    \
+    func##test_case##test_name<AdaptiveTable>();                                               \
+}                                                                                              \
+TEST(test_case##CompressedSortedTable, test_name) {                                            \
+    func##test_case##test_name<CompressedSortedTable>();                                       \
+}                                                                                              \
+TEST(test_case##LsmSortedTable, test_name) {                                                   \
+    func##test_case##test_name<LsmSortedTable>();                                              \
+}                                                                                              \
+TEST(test_case##OutOfCoreHashTable, test_name) {                                               \
+    func##test_case##test_name<OutOfCoreHashTable>();                                          \
+}                                                                                              \
 template <template<class> class TableType>                                                     \
 void func##test_case##test_name()
 
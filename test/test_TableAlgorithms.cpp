@@ -0,0 +1,220 @@
+#include "TableAlgorithms.h"
+#include <map>
+#include <random>
+#include <vector>
+
+#include "gtest/gtest.h"
+
+// tables are filled by random keys, std::map is a reference
+template <class TableType>
+class TestTableAlgorithms : public testing::Test {
+
+public:
+
+    TableType a, b;
+    std::map<KeyType, int> refA, refB;
+
+    void fill(size_t sizeA, size_t sizeB, KeyType maxKey) {
+        std::default_random_engine randGen(1);
+        std::uniform_int_distribution<KeyType> dist(0, maxKey);
+        for (size_t i = 0; i < sizeA; i++) {
+            KeyType key = dist(randGen);
+            a.insert(key, int(key));
+            refA.insert(std::make_pair(key, int(key)));
+        }
+        for (size_t i = 0; i < sizeB; i++) {
+            KeyType key = dist(randGen);
+            b.insert(key, -int(key));
+            refB.insert(std::make_pair(key, -int(key)));
+        }
+    }
+
+    static void checkTable(const std::map<KeyType, int>& expected, TableType table) {
+        ASSERT_EQ(expected.size(), table.getSize());
+        for (const auto& elem : expected) {
+            auto it = table.find(elem.first);
+            ASSERT_NE(table.end(), it);
+            ASSERT_EQ(elem.second, it->second);
+        }
+    }
+
+    std::map<KeyType, int> getIntersection() const {
+        std::map<KeyType, int> res;
+        for (const auto& elem : refA)
+            if (refB.count(elem.first) != 0)
+                res.insert(elem);
+        return res;
+    }
+
+    std::map<KeyType, int> getUnion() const {
+        std::map<KeyType, int> res = refA;
+        res.insert(refB.begin(), refB.end());
+        return res;
+    }
+
+    std::map<KeyType, int> getDifference() const {
+        std::map<KeyType, int> res;
+        for (const auto& elem : refA)
+            if (refB.count(elem.first) == 0)
+                res.insert(elem);
+        return res;
+    }
+
+};
+
+typedef ::testing::Types<HashTableOpenAddressing<int>, HashTableSeparateChaining<int>,
+    SortedTable<int>> TestTableAlgorithmsTypes;
+TYPED_TEST_SUITE(TestTableAlgorithms, TestTableAlgorithmsTypes);
+
+TYPED_TEST(TestTableAlgorithms, can_intersect_tables) {
+    this->fill(2000, 3000, 5000);
+
+    auto res = intersect(this->a, this->b);
+
+    this->checkTable(this->getIntersection(), res);
+}
+
+TYPED_TEST(TestTableAlgorithms, can_unite_tables) {
+    this->fill(2000, 3000, 5000);
+
+    auto res = unite(this->a, this->b);
+
+    this->checkTable(this->getUnion(), res);
+}
+
+TYPED_TEST(TestTableAlgorithms, can_find_difference_of_tables) {
+    this->fill(2000, 3000, 5000);
+
+    auto res = difference(this->a, this->b);
+
+    this->checkTable(this->getDifference(), res);
+}
+
+TYPED_TEST(TestTableAlgorithms, can_join_tables) {
+    this->fill(2000, 3000, 5000);
+    std::map<KeyType, std::pair<int, int>> joined;
+
+    join(this->a, this->b, [&joined](KeyType key, int& elemA, int& elemB) {
+        joined[key] = std::make_pair(elemA, elemB);
+    });
+
+    auto expected = this->getIntersection();
+    ASSERT_EQ(expected.size(), joined.size());
+    for (const auto& elem : expected)
+        ASSERT_EQ(std::make_pair(elem.second, -elem.second), joined[elem.first]);
+}
+
+TYPED_TEST(TestTableAlgorithms, can_join_tables_of_very_different_sizes) {
+    this->fill(50, 20000, 30000);
+    size_t joinedCount = 0;
+
+    join(this->a, this->b, [&joinedCount](KeyType key, int& elemA, int& elemB) {
+        if (elemA == int(key) && elemB == -int(key))
+            joinedCount++;
+    });
+    join(this->b, this->a, [&joinedCount](KeyType key, int& elemB, int& elemA) {
+        if (elemA == int(key) && elemB == -int(key))
+            joinedCount++;
+    });
+
+    ASSERT_EQ(2 * this->getIntersection().size(), joinedCount);
+    this->checkTable(this->getDifference(), difference(this->a, this->b));
+}
+
+TYPED_TEST(TestTableAlgorithms, operations_with_empty_table_are_correct) {
+    this->fill(100, 0, 1000);
+
+    auto intersection = intersect(this->a, this->b);
+    auto uniteRes = unite(this->b, this->a);
+
+    ASSERT_TRUE(intersection.isEmpty());
+    this->checkTable(this->refA, uniteRes);
+}
+
+
+template <class TableType>
+class TestHashTableAlgorithms : public TestTableAlgorithms<TableType> {};
+
+typedef ::testing::Types<HashTableOpenAddressing<int>, HashTableSeparateChaining<int>> TestHashTableAlgorithmsTypes;
+TYPED_TEST_SUITE(TestHashTableAlgorithms, TestHashTableAlgorithmsTypes);
+
+TYPED_TEST(TestHashTableAlgorithms, large_tables_are_split_into_partitions) {
+    this->fill(100000, 100000, 1000000);
+
+    HashTablePartitionedMatcher<TypeParam, TypeParam> matcher(this->a, this->b, 1);
+
+    ASSERT_GT(matcher.getPartitionsCount(), 1);
+    this->checkTable(this->getIntersection(), intersect(this->a, this->b));
+}
+
+TYPED_TEST(TestHashTableAlgorithms, can_process_partitions_by_several_threads) {
+    this->fill(20000, 30000, 50000);
+
+    this->checkTable(this->getIntersection(), intersect(this->a, this->b, 4));
+    this->checkTable(this->getUnion(), unite(this->a, this->b, 4));
+    this->checkTable(this->getDifference(), difference(this->a, this->b, 3));
+}
+
+TYPED_TEST(TestHashTableAlgorithms, can_join_tables_by_several_threads) {
+    this->fill(20000, 30000, 50000);
+    std::vector<size_t> joinedCounts(4, 0);
+
+    HashTablePartitionedMatcher<TypeParam, TypeParam> matcher(this->a, this->b, 4);
+    matcher.run([&joinedCounts](size_t thread, KeyType, int&, int* elemB) {
+        if (elemB != nullptr)
+            joinedCounts[thread]++;
+    });
+
+    ASSERT_EQ(this->getIntersection().size(), joinedCounts[0] + joinedCounts[1] + joinedCounts[2] + joinedCounts[3]);
+}
+
+
+TEST(TestSortedTableAlgorithms, erased_elements_are_skipped) {
+    SortedTable<int> a, b;
+    a.setLazyErasing(true);
+    b.setLazyErasing(true);
+    for (KeyType key = 0; key < 100; key++) {
+        a.insert(key, 0);
+        b.insert(key, 1);
+    }
+    for (KeyType key = 0; key < 100; key += 3)
+        a.erase(key);
+    for (KeyType key = 0; key < 100; key += 2)
+        b.erase(key);
+
+    auto res = intersect(a, b);
+
+    for (KeyType key = 0; key < 100; key++)
+        ASSERT_EQ(key % 2 != 0 && key % 3 != 0, res.find(key) != res.end());
+}
+
+TEST(TestSortedTableAlgorithms, join_calls_callback_in_ascending_order) {
+    SortedTable<int> a, b;
+    for (KeyType key = 0; key < 1000; key++)
+        a.insert(999 - key, 0);
+    for (KeyType key = 0; key < 1000; key += 7)
+        b.insert(key, 0);
+    std::vector<KeyType> keys;
+
+    join(a, b, [&keys](KeyType key, int&, int&) {
+        keys.push_back(key);
+    });
+
+    ASSERT_EQ(143, keys.size());
+    ASSERT_TRUE(std::is_sorted(keys.begin(), keys.end()));
+}
+
+TEST(TestSortedTableAlgorithms, lower_bound_with_galloping_finds_key) {
+    SortedTable<int> table;
+    for (KeyType key = 0; key < 1000; key++)
+        table.insert(2 * key, 0);
+
+    auto it = table.lowerBound(10, table.begin());
+    auto it2 = table.lowerBound(1001, it);
+    auto it3 = table.lowerBound(5000, it2);
+
+    ASSERT_EQ(10, it->first);
+    ASSERT_EQ(1002, it2->first);
+    ASSERT_EQ(table.end(), it3);
+    ASSERT_EQ(1002, table.lowerBound(1001)->first);
+}
@@ -0,0 +1,92 @@
+#include "TableTrace.h"
+#include "HashTable.h"
+#include "SortedTable.h"
+#include <sstream>
+
+#include "gtest/gtest.h"
+
+bool operator==(const TraceRecord& a, const TraceRecord& b) {
+    return a.operation == b.operation && a.key == b.key && a.valueSize == b.valueSize;
+}
+
+TEST(TestTableTrace, can_read_written_records) {
+    std::stringstream stream;
+    std::vector<TraceRecord> records = {
+        { TraceOperation::INSERT, 1, 10 },
+        { TraceOperation::FIND, 0xFFFFFFFF, 0 },
+        { TraceOperation::ERASE, 123456789, 0 },
+        { TraceOperation::INSERT, 7, 0x80000000 }
+    };
+
+    TraceWriter writer(stream);
+    for (const auto& record : records)
+        writer.write(record);
+    TraceReader reader(stream);
+
+    ASSERT_EQ(records, reader.readAll());
+}
+
+TEST(TestTableTrace, record_has_fixed_size) {
+    std::stringstream stream;
+
+    TraceWriter writer(stream);
+    writer.write(TraceRecord{ TraceOperation::INSERT, 1, 10 });
+
+    ASSERT_EQ(sizeof(TRACE_MAGIC) + TRACE_RECORD_SIZE, stream.str().size());
+}
+
+TEST(TestTableTrace, throw_exception_when_stream_is_not_trace) {
+    std::stringstream stream("not a trace");
+
+    ASSERT_ANY_THROW(TraceReader reader(stream));
+}
+
+TEST(TestTableTrace, throw_exception_when_operation_is_unknown) {
+    std::stringstream stream;
+    TraceWriter writer(stream);
+    stream.write("\x07\0\0\0\0\0\0\0\0", TRACE_RECORD_SIZE);
+    TraceReader reader(stream);
+    TraceRecord record;
+
+    ASSERT_ANY_THROW(reader.read(record));
+}
+
+TEST(TestTableTrace, recording_table_changes_table) {
+    std::stringstream stream;
+    SortedTable<std::string> table;
+    TraceRecordingTable<SortedTable<std::string>> recordingTable(table, stream);
+
+    recordingTable.insert(1, std::string("abc"));
+    recordingTable.insert(2, std::string("de"));
+    recordingTable.erase(1);
+
+    ASSERT_EQ(1, table.getSize());
+    ASSERT_EQ("de", recordingTable.find(2)->second);
+}
+
+TEST(TestTableTrace, recording_table_writes_all_operations) {
+    std::stringstream stream;
+    HashTableOpenAddressing<std::string> table;
+    TraceRecordingTable<HashTableOpenAddressing<std::string>> recordingTable(table, stream);
+    std::string value = "abcd";
+
+    recordingTable.insert(5, value);
+    recordingTable.find(5);
+    recordingTable.find(6);
+    recordingTable.erase(5);
+    TraceReader reader(stream);
+
+    std::vector<TraceRecord> expected = {
+        { TraceOperation::INSERT, 5, 4 },
+        { TraceOperation::FIND, 5, 0 },
+        { TraceOperation::FIND, 6, 0 },
+        { TraceOperation::ERASE, 5, 0 }
+    };
+    ASSERT_EQ(expected, reader.readAll());
+    ASSERT_EQ("abcd", value);
+}
+
+TEST(TestTableTrace, value_size_of_vector_is_size_of_data) {
+    ASSERT_EQ(3 * sizeof(int), getTraceValueSize(std::vector<int>(3)));
+    ASSERT_EQ(sizeof(double), getTraceValueSize(1.0));
+}
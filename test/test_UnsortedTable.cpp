@@ -0,0 +1,40 @@
+#include "UnsortedTable.h"
+#include <string>
+#include <vector>
+
+#include "gtest/gtest.h"
+
+class TestUnsortedTable : public testing::Test {
+
+public:
+
+    UnsortedTable<std::string> table;
+
+    TestUnsortedTable() {
+        for (KeyType i = 0; i < 10; i++)
+            table.insert(9 - i, std::string(1, char('a' + i)));
+    }
+
+};
+
+TEST_F(TestUnsortedTable, can_erase_if) {
+    size_t erased = table.eraseIf([](const std::pair<KeyType, std::string>& elem) {
+        return elem.first % 2 == 0;
+    });
+
+    ASSERT_EQ(5, erased);
+    ASSERT_EQ(5, table.getSize());
+    ASSERT_EQ(table.end(), table.find(4));
+    ASSERT_EQ("e", table.find(5)->second);
+}
+
+TEST_F(TestUnsortedTable, can_erase_keys) {
+    std::vector<KeyType> keys = { 1, 3, 4, 9, 15 };
+
+    size_t erased = table.eraseKeys(keys.begin(), keys.end());
+
+    ASSERT_EQ(4, erased);
+    ASSERT_EQ(6, table.getSize());
+    ASSERT_EQ(table.end(), table.find(9));
+    ASSERT_EQ("h", table.find(2)->second);
+}